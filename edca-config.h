@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EDCA_CONFIG_H
+#define EDCA_CONFIG_H
+
+#include "trace-replay-format.h"
+
+#include "ns3/attribute-container.h"
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/qos-utils.h"
+#include "ns3/queue-size.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <map>
+#include <string>
+
+/**
+ * MAC and EDCA configuration shared by single-bss-sld-edca and independent-bss-batch.
+ */
+
+/**
+ * Sets the MAC defaults of the EDCA scenarios: MSDUs of up to payloadSize bytes (or replayed
+ * packets) are never fragmented, retransmissions are persistent and queues are unlimited and
+ * keep their MPDUs for maxDelay.
+ */
+inline void
+SetEdcaMacDefaults(const uint32_t payloadSize, const ns3::Time& maxDelay)
+{
+    using namespace ns3;
+
+    Config::SetDefault("ns3::WifiRemoteStationManager::FragmentationThreshold",
+                       UintegerValue(std::max(payloadSize, TRACE_REPLAY_MAX_SIZE) + 100));
+    Config::SetDefault("ns3::WifiRemoteStationManager::MaxSlrc",
+                       UintegerValue(std::numeric_limits<uint32_t>::max()));
+    Config::SetDefault("ns3::WifiRemoteStationManager::MaxSsrc",
+                       UintegerValue(std::numeric_limits<uint32_t>::max()));
+    Config::SetDefault(
+        "ns3::WifiMacQueue::MaxSize",
+        QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, std::numeric_limits<uint32_t>::max())));
+    Config::SetDefault("ns3::WifiMacQueue::MaxDelay", TimeValue(maxDelay));
+}
+
+/// AIFSN of an AC, the AIFS of AC_VI and AC_VO equals the legacy DIFS
+inline uint64_t
+GetEdcaAifsn(const ns3::AcIndex ac)
+{
+    static const std::map<ns3::AcIndex, uint64_t> aifsns = {{ns3::AC_BE, 3},
+                                                            {ns3::AC_BK, 7},
+                                                            {ns3::AC_VI, 2},
+                                                            {ns3::AC_VO, 2}};
+    return aifsns.at(ac);
+}
+
+/// TXOP limit of an AC
+inline ns3::Time
+GetEdcaTxopLimit(const ns3::AcIndex ac)
+{
+    static const std::map<ns3::AcIndex, ns3::Time> txopLimits = {
+        {ns3::AC_BE, ns3::MicroSeconds(0)},
+        {ns3::AC_BK, ns3::MicroSeconds(0)},
+        {ns3::AC_VI, ns3::MicroSeconds(1536)},
+        {ns3::AC_VO, ns3::MicroSeconds(320)}};
+    return txopLimits.at(ac);
+}
+
+/**
+ * Sets the CWs, AIFSNs and TXOP limits of every AC on all the wifi devices (APs included,
+ * since STAs sync with the AP via association, probe, and beacon). minCws and maxCws hold
+ * one CW per link for every AC.
+ */
+inline void
+SetEdcaParameters(const std::map<ns3::AcIndex, std::list<uint64_t>>& minCws,
+                  const std::map<ns3::AcIndex, std::list<uint64_t>>& maxCws)
+{
+    using namespace ns3;
+
+    const std::string prefixStr = "/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/";
+    for (const auto& [ac, name] : {std::make_pair(AC_BE, "BE"),
+                                   std::make_pair(AC_BK, "BK"),
+                                   std::make_pair(AC_VI, "VI"),
+                                   std::make_pair(AC_VO, "VO")})
+    {
+        const auto nLinks = minCws.at(ac).size();
+        Config::Set(prefixStr + name + "_Txop/MinCws",
+                    AttributeContainerValue<UintegerValue>(minCws.at(ac)));
+        Config::Set(prefixStr + name + "_Txop/MaxCws",
+                    AttributeContainerValue<UintegerValue>(maxCws.at(ac)));
+        Config::Set(prefixStr + name + "_Txop/Aifsns",
+                    AttributeContainerValue<UintegerValue>(
+                        std::list<uint64_t>(nLinks, GetEdcaAifsn(ac))));
+        Config::Set(prefixStr + name + "_Txop/TxopLimits",
+                    AttributeContainerValue<TimeValue>(
+                        std::list<Time>(nLinks, GetEdcaTxopLimit(ac))));
+    }
+}
+
+#endif /* EDCA_CONFIG_H */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EDCA_MAC_TRACE_H
+#define EDCA_MAC_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Binary MAC event trace written by single-bss-sld-edca (--macTraceFile) and read by
+ * mac-trace-decode.
+ *
+ * The file is a MacTraceFileHeader followed by MacTraceRecords. Records are grouped in
+ * per-node batches as they are flushed, so they are only time ordered within a node.
+ *
+ * The end of AIFS is not an event of the channel access manager: MAC_TRACE_AIFS_PROJECTED is
+ * stamped with the time of the backoff draw and only carries the projection made at that time,
+ * which later medium activity can push back.
+ */
+constexpr char MAC_TRACE_MAGIC[8] = {'E', 'D', 'C', 'A', 'M', 'A', 'C', '1'};
+constexpr uint32_t MAC_TRACE_VERSION = 2;
+constexpr uint8_t MAC_TRACE_NO_LINK = 0xff;
+
+enum MacTraceEvent : uint8_t
+{
+    MAC_TRACE_BACKOFF_DRAWN,    // arg: backoff slots drawn
+    MAC_TRACE_AIFS_PROJECTED,   // logged with the draw, arg: ns until AIFS is projected to end
+    MAC_TRACE_TX_START,         // arg: sequence number of the first MPDU
+    MAC_TRACE_COLLISION,        // MPDU not acknowledged, arg: sequence number
+    MAC_TRACE_ACK,              // MPDU acknowledged, arg: sequence number
+    MAC_TRACE_DEQUEUE,          // MPDU removed from the AC queue, arg: sequence number
+    MAC_TRACE_NUM_EVENTS
+};
+
+inline const char*
+GetMacTraceEventName(uint8_t event)
+{
+    static const char* names[MAC_TRACE_NUM_EVENTS] =
+        {"BACKOFF", "AIFS_PROJECTED", "TX", "COLLISION", "ACK", "DEQUEUE"};
+    return event < MAC_TRACE_NUM_EVENTS ? names[event] : "UNKNOWN";
+}
+
+struct MacTraceFileHeader
+{
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_recordSize; // sizeof(MacTraceRecord)
+};
+
+#pragma pack(push, 1)
+
+struct MacTraceRecord
+{
+    uint64_t m_timeNs;
+    uint32_t m_nodeId;
+    uint32_t m_arg; // see MacTraceEvent
+    uint8_t m_event;
+    uint8_t m_ac;     // AcIndex
+    uint8_t m_linkId; // MAC_TRACE_NO_LINK when the event is not bound to a link
+    uint8_t m_reserved;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(MacTraceFileHeader) == 16, "unexpected MAC trace header size");
+static_assert(sizeof(MacTraceRecord) == 20, "unexpected MAC trace record size");
+
+/**
+ * Single producer, single consumer lock-free ring of trace records. The simulator thread
+ * pushes, the writer thread pops.
+ */
+class MacTraceRingBuffer
+{
+  public:
+    explicit MacTraceRingBuffer(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_records.resize(size);
+        m_mask = size - 1;
+    }
+
+    /// Returns false (and drops the record) if the ring is full
+    bool Push(const MacTraceRecord& record)
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+        {
+            return false;
+        }
+        m_records[head & m_mask] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Copies up to maxRecords records to out, returns the number copied
+    std::size_t Pop(MacTraceRecord* out, std::size_t maxRecords)
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint64_t available = m_head.load(std::memory_order_acquire) - tail;
+        const std::size_t count = available < maxRecords ? available : maxRecords;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = m_records[(tail + i) & m_mask];
+        }
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+  private:
+    std::vector<MacTraceRecord> m_records;
+    std::size_t m_mask;
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+};
+
+/**
+ * Owns one ring per node and a background thread draining the rings into the trace file,
+ * so the simulator never waits on file I/O. Records arriving while a ring is full are
+ * dropped and counted.
+ */
+class MacTraceWriter
+{
+  public:
+    MacTraceWriter(const std::string& fileName, std::size_t nNodes, std::size_t ringCapacity)
+        : m_file(std::fopen(fileName.c_str(), "wb"))
+    {
+        if (!m_file)
+        {
+            return;
+        }
+        MacTraceFileHeader header;
+        std::memcpy(header.m_magic, MAC_TRACE_MAGIC, sizeof(header.m_magic));
+        header.m_version = MAC_TRACE_VERSION;
+        header.m_recordSize = sizeof(MacTraceRecord);
+        std::fwrite(&header, sizeof(header), 1, m_file);
+        for (std::size_t i = 0; i < nNodes; ++i)
+        {
+            m_rings.emplace_back(std::make_unique<MacTraceRingBuffer>(ringCapacity));
+        }
+        m_thread = std::thread(&MacTraceWriter::Run, this);
+    }
+
+    ~MacTraceWriter()
+    {
+        Close();
+    }
+
+    bool IsOpen() const
+    {
+        return m_file != nullptr;
+    }
+
+    void Record(const MacTraceRecord& record)
+    {
+        if (record.m_nodeId >= m_rings.size() || !m_rings[record.m_nodeId]->Push(record))
+        {
+            ++m_dropped;
+        }
+    }
+
+    /// Stops the writer thread after the rings are drained and closes the file
+    void Close()
+    {
+        if (!m_file)
+        {
+            return;
+        }
+        m_stop.store(true, std::memory_order_release);
+        m_thread.join();
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    uint64_t GetWritten() const
+    {
+        return m_written;
+    }
+
+    uint64_t GetDropped() const
+    {
+        return m_dropped;
+    }
+
+  private:
+    void Run()
+    {
+        std::vector<MacTraceRecord> batch(4096);
+        while (true)
+        {
+            // read the flag before draining, so that nothing pushed before Close() is lost
+            const bool stop = m_stop.load(std::memory_order_acquire);
+            std::size_t drained = 0;
+            for (auto& ring : m_rings)
+            {
+                std::size_t count;
+                while ((count = ring->Pop(batch.data(), batch.size())) > 0)
+                {
+                    std::fwrite(batch.data(), sizeof(MacTraceRecord), count, m_file);
+                    drained += count;
+                }
+            }
+            m_written += drained;
+            if (stop)
+            {
+                break;
+            }
+            if (drained == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    std::FILE* m_file;
+    std::vector<std::unique_ptr<MacTraceRingBuffer>> m_rings;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    uint64_t m_written{0}; // only touched by the writer thread until Close() returns
+    uint64_t m_dropped{0}; // only touched by the simulator thread
+};
+
+#endif /* EDCA_MAC_TRACE_H */
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EDCA_PACKET_RECORDS_H
+#define EDCA_PACKET_RECORDS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Per-packet records written by single-bss-sld-edca (--packetRecordFile) and read by
+ * packet-records-read.
+ *
+ * The file is a PacketRecordFileHeader followed by blocks. Each block holds the records of
+ * one node and AC, in acknowledgement order, as a PacketRecordBlockHeader and a payload of
+ * columns, one column after the other:
+ *   enqueue time  zigzag varint, ns relative to the previous record (0 for the first one)
+ *   dequeue time  zigzag varint, ns relative to the previous record (0 for the first one)
+ *   failures      varint
+ *   destination   varint node ID
+ *   link          varint ID of the link of the acknowledged transmission
+ * Blocks are self-contained; the head-of-line time of a record is not stored, it is
+ * max(enqueue, previous dequeue) of the same node and AC whatever the link, since the links
+ * of an MLD are served by one queue per AC.
+ */
+constexpr char PACKET_RECORD_MAGIC[8] = {'E', 'D', 'C', 'A', 'P', 'K', 'T', '1'};
+constexpr uint32_t PACKET_RECORD_VERSION = 2;
+
+struct PacketRecordFileHeader
+{
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_reserved;
+};
+
+struct PacketRecordBlockHeader
+{
+    uint32_t m_nodeId;
+    uint8_t m_ac; // AcIndex
+    uint8_t m_reserved[3];
+    uint32_t m_numRecords;
+    uint32_t m_payloadSize; // bytes
+};
+
+static_assert(sizeof(PacketRecordFileHeader) == 16, "unexpected packet record header size");
+static_assert(sizeof(PacketRecordBlockHeader) == 16, "unexpected packet record block size");
+
+struct PacketRecord
+{
+    uint64_t m_enqueueNs;
+    uint64_t m_dequeueNs;
+    uint32_t m_failures;
+    uint32_t m_dst;
+    uint8_t m_linkId;
+};
+
+inline void
+PutVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/// Returns false if the varint runs past end
+inline bool
+GetVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (unsigned shift = 0; pos < end && shift < 64; shift += 7)
+    {
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t
+ZigZagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t
+ZigZagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void
+EncodePacketRecords(const std::vector<PacketRecord>& records, std::vector<uint8_t>& payload)
+{
+    payload.clear();
+    uint64_t previous = 0;
+    for (const auto& record : records)
+    {
+        PutVarint(payload, ZigZagEncode(static_cast<int64_t>(record.m_enqueueNs - previous)));
+        previous = record.m_enqueueNs;
+    }
+    previous = 0;
+    for (const auto& record : records)
+    {
+        PutVarint(payload, ZigZagEncode(static_cast<int64_t>(record.m_dequeueNs - previous)));
+        previous = record.m_dequeueNs;
+    }
+    for (const auto& record : records)
+    {
+        PutVarint(payload, record.m_failures);
+    }
+    for (const auto& record : records)
+    {
+        PutVarint(payload, record.m_dst);
+    }
+    for (const auto& record : records)
+    {
+        PutVarint(payload, record.m_linkId);
+    }
+}
+
+/// Returns false if the payload does not hold numRecords records
+inline bool
+DecodePacketRecords(const uint8_t* payload,
+                    std::size_t size,
+                    uint32_t numRecords,
+                    std::vector<PacketRecord>& records)
+{
+    const uint8_t* pos = payload;
+    const uint8_t* end = payload + size;
+    uint64_t value;
+    records.resize(numRecords);
+    uint64_t previous = 0;
+    for (auto& record : records)
+    {
+        if (!GetVarint(pos, end, value))
+        {
+            return false;
+        }
+        record.m_enqueueNs = previous + ZigZagDecode(value);
+        previous = record.m_enqueueNs;
+    }
+    previous = 0;
+    for (auto& record : records)
+    {
+        if (!GetVarint(pos, end, value))
+        {
+            return false;
+        }
+        record.m_dequeueNs = previous + ZigZagDecode(value);
+        previous = record.m_dequeueNs;
+    }
+    for (auto& record : records)
+    {
+        if (!GetVarint(pos, end, value))
+        {
+            return false;
+        }
+        record.m_failures = static_cast<uint32_t>(value);
+    }
+    for (auto& record : records)
+    {
+        if (!GetVarint(pos, end, value))
+        {
+            return false;
+        }
+        record.m_dst = static_cast<uint32_t>(value);
+    }
+    for (auto& record : records)
+    {
+        if (!GetVarint(pos, end, value))
+        {
+            return false;
+        }
+        record.m_linkId = static_cast<uint8_t>(value);
+    }
+    return pos == end;
+}
+
+/**
+ * Buffers records per node and AC and writes a block whenever a buffer holds blockSize
+ * records, so that memory stays bounded however long the run is.
+ */
+class PacketRecordWriter
+{
+  public:
+    PacketRecordWriter(const std::string& fileName, std::size_t blockSize)
+        : m_file(std::fopen(fileName.c_str(), "wb")),
+          m_blockSize(blockSize > 0 ? blockSize : 1)
+    {
+        if (!m_file)
+        {
+            return;
+        }
+        PacketRecordFileHeader header;
+        std::memcpy(header.m_magic, PACKET_RECORD_MAGIC, sizeof(header.m_magic));
+        header.m_version = PACKET_RECORD_VERSION;
+        header.m_reserved = 0;
+        std::fwrite(&header, sizeof(header), 1, m_file);
+    }
+
+    ~PacketRecordWriter()
+    {
+        Close();
+    }
+
+    bool IsOpen() const
+    {
+        return m_file != nullptr;
+    }
+
+    void Add(uint32_t nodeId, uint8_t ac, const PacketRecord& record)
+    {
+        auto& buffer = m_buffers[{nodeId, ac}];
+        if (buffer.empty())
+        {
+            buffer.reserve(m_blockSize);
+        }
+        buffer.push_back(record);
+        if (buffer.size() >= m_blockSize)
+        {
+            WriteBlock(nodeId, ac, buffer);
+        }
+    }
+
+    /// Writes the partial blocks and closes the file
+    void Close()
+    {
+        if (!m_file)
+        {
+            return;
+        }
+        for (auto& entry : m_buffers)
+        {
+            WriteBlock(entry.first.first, entry.first.second, entry.second);
+        }
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    uint64_t GetRecords() const
+    {
+        return m_records;
+    }
+
+    uint64_t GetBytes() const
+    {
+        return m_bytes;
+    }
+
+  private:
+    void WriteBlock(uint32_t nodeId, uint8_t ac, std::vector<PacketRecord>& records)
+    {
+        if (records.empty())
+        {
+            return;
+        }
+        EncodePacketRecords(records, m_payload);
+        PacketRecordBlockHeader header{};
+        header.m_nodeId = nodeId;
+        header.m_ac = ac;
+        header.m_numRecords = static_cast<uint32_t>(records.size());
+        header.m_payloadSize = static_cast<uint32_t>(m_payload.size());
+        std::fwrite(&header, sizeof(header), 1, m_file);
+        std::fwrite(m_payload.data(), 1, m_payload.size(), m_file);
+        m_records += records.size();
+        m_bytes += sizeof(header) + m_payload.size();
+        records.clear();
+    }
+
+    std::FILE* m_file;
+    std::size_t m_blockSize;
+    std::map<std::pair<uint32_t, uint8_t>, std::vector<PacketRecord>> m_buffers;
+    std::vector<uint8_t> m_payload;
+    uint64_t m_records{0};
+    uint64_t m_bytes{0};
+};
+
+#endif /* EDCA_PACKET_RECORDS_H */
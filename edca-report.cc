@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Aggregates wifi-edca.dat result rows of single-bss-sld-edca in one streaming pass over any
+// number of files. Rows are grouped by configuration columns and every metric column gets
+// its mean, 95% confidence interval and percentiles, printed as one plot-ready row per group
+// and metric:
+//   <group columns>,metric,n,mean,ci95,p50,p90,p99
+
+#include "ns3/command-line.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+// Columns of a wifi-edca.dat row, in the order written by single-bss-sld-edca
+const std::vector<std::string> BASE_COLUMNS = {
+    "succPr_BE",      "succPr_BK",      "succPr_VI",      "succPr_VO",      "succPr_total",
+    "thpt_BE",        "thpt_BK",        "thpt_VI",        "thpt_VO",        "thpt_total",
+    "queDelay_BE",    "queDelay_BK",    "queDelay_VI",    "queDelay_VO",    "queDelay_total",
+    "accDelay_BE",    "accDelay_BK",    "accDelay_VI",    "accDelay_VO",    "accDelay_total",
+    "e2eDelay_BE",    "e2eDelay_BK",    "e2eDelay_VI",    "e2eDelay_VO",    "e2eDelay_total",
+    "rngRun",         "simulationTime", "payloadSize",    "mcs",            "channelWidth",
+    "nSld",           "perSldLambda",   "acInt_BE",       "acInt_BK",       "acInt_VI",
+    "acInt_VO",       "acBECwmin",      "acBECwStage",    "acBKCwmin",      "acBKCwStage",
+    "acVICwmin",      "acVICwStage",    "acVOCwmin",      "acVOCwStage"};
+
+const std::vector<std::string> QUEUE_COLUMNS = {"queueMeanPkts",
+                                                "queueMaxPkts",
+                                                "queueFinalPkts",
+                                                "queueMeanBytes",
+                                                "queueMaxBytes",
+                                                "queueFinalBytes",
+                                                "queueMaxHolAgeMs",
+                                                "queueUnstable"};
+
+// Per AC columns following the 99th percentile delays
+const std::vector<std::string> QUEUE_TREND_COLUMNS = {"queueGrowthPkts", "queueMaxStaPkts"};
+
+// Configuration columns, i.e. everything from rngRun to acVOCwStage
+constexpr std::size_t FIRST_CONFIG_COLUMN = 25;
+constexpr std::size_t LAST_CONFIG_COLUMN = 43;
+
+std::vector<std::string>
+GetColumnNames()
+{
+    auto columns = BASE_COLUMNS;
+    for (const auto& ac : {"BE", "BK", "VI", "VO"})
+    {
+        for (const auto& name : QUEUE_COLUMNS)
+        {
+            columns.push_back(name + "_" + ac);
+        }
+    }
+    for (const auto& ac : {"BE", "BK", "VI", "VO"})
+    {
+        columns.push_back(std::string("e2eDelayP99_") + ac);
+    }
+    for (const auto& ac : {"BE", "BK", "VI", "VO"})
+    {
+        for (const auto& name : QUEUE_TREND_COLUMNS)
+        {
+            columns.push_back(name + "_" + ac);
+        }
+    }
+    return columns;
+}
+
+std::vector<std::string>
+Split(const std::string& str)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(str);
+    for (std::string item; std::getline(stream, item, ',');)
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+double
+GetT95(std::size_t df)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    return df == 0 ? 0 : (df <= 30 ? table[df - 1] : 1.960);
+}
+
+// Linear interpolation between the closest ranks of sorted values
+double
+GetPercentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    double rank = p * (sorted.size() - 1);
+    auto low = static_cast<std::size_t>(rank);
+    auto high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (rank - low) * (sorted[high] - sorted[low]);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string input{"wifi-edca.dat"};
+    std::string output{""};
+    std::string groupBy{""};
+    std::string metrics{""};
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Comma separated result files", input);
+    cmd.AddValue("output", "Output table (stdout if empty)", output);
+    cmd.AddValue("groupBy",
+                 "Comma separated columns defining a group (default: all configuration "
+                 "columns except rngRun, i.e. replications are aggregated)",
+                 groupBy);
+    cmd.AddValue("metrics",
+                 "Comma separated metric columns, unnamed trailing columns are colN "
+                 "(default: all named metrics)",
+                 metrics);
+    cmd.Parse(argc, argv);
+
+    // columns appended after the known ones are addressed as colN (0-based)
+    auto columns = GetColumnNames();
+    auto getIndex = [&columns](const std::string& name) -> int {
+        auto it = std::find(columns.begin(), columns.end(), name);
+        if (it != columns.end())
+        {
+            return static_cast<int>(it - columns.begin());
+        }
+        if (name.compare(0, 3, "col") == 0 && name.size() > 3 &&
+            name.find_first_not_of("0123456789", 3) == std::string::npos)
+        {
+            auto index = std::stoul(name.substr(3));
+            while (columns.size() <= index)
+            {
+                columns.push_back("col" + std::to_string(columns.size()));
+            }
+            return static_cast<int>(index);
+        }
+        return -1;
+    };
+
+    std::vector<std::size_t> groupIndices;
+    std::vector<std::size_t> metricIndices;
+    if (groupBy.empty())
+    {
+        for (auto i = FIRST_CONFIG_COLUMN + 1; i <= LAST_CONFIG_COLUMN; ++i)
+        {
+            groupIndices.push_back(i);
+        }
+    }
+    for (const auto& name : Split(groupBy))
+    {
+        if (getIndex(name) < 0)
+        {
+            std::cout << "unknown column " << name << "\n";
+            return 1;
+        }
+        groupIndices.push_back(getIndex(name));
+    }
+    if (metrics.empty())
+    {
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            if (i < FIRST_CONFIG_COLUMN || i > LAST_CONFIG_COLUMN)
+            {
+                metricIndices.push_back(i);
+            }
+        }
+    }
+    for (const auto& name : Split(metrics))
+    {
+        if (getIndex(name) < 0)
+        {
+            std::cout << "unknown column " << name << "\n";
+            return 1;
+        }
+        metricIndices.push_back(getIndex(name));
+    }
+
+    // metric samples of every group, keyed by the numeric values of the group columns
+    std::map<std::vector<double>, std::vector<std::vector<double>>> groups;
+    std::vector<double> row;
+    uint64_t numRows = 0;
+    for (const auto& fileName : Split(input))
+    {
+        std::ifstream in(fileName);
+        if (!in)
+        {
+            std::cout << "cannot open " << fileName << "\n";
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            row.clear();
+            const char* pos = line.c_str();
+            while (*pos != '\0')
+            {
+                char* end;
+                row.push_back(std::strtod(pos, &end));
+                pos = (*end == ',') ? end + 1 : end;
+                if (end == pos && *end != '\0')
+                {
+                    break; // malformed token
+                }
+            }
+            if (row.size() <= LAST_CONFIG_COLUMN)
+            {
+                continue; // empty or truncated row
+            }
+            std::vector<double> key;
+            key.reserve(groupIndices.size());
+            for (auto index : groupIndices)
+            {
+                key.push_back(row[index]);
+            }
+            auto& samples = groups[key];
+            samples.resize(metricIndices.size());
+            for (std::size_t m = 0; m < metricIndices.size(); ++m)
+            {
+                // rows written before the queue probes existed lack the trailing columns
+                if (metricIndices[m] < row.size())
+                {
+                    samples[m].push_back(row[metricIndices[m]]);
+                }
+            }
+            ++numRows;
+        }
+    }
+
+    std::ofstream outFile;
+    if (!output.empty())
+    {
+        outFile.open(output);
+    }
+    std::ostream& out = output.empty() ? std::cout : outFile;
+
+    for (auto index : groupIndices)
+    {
+        out << columns[index] << ",";
+    }
+    out << "metric,n,mean,ci95,p50,p90,p99\n";
+    for (auto& group : groups)
+    {
+        for (std::size_t m = 0; m < metricIndices.size(); ++m)
+        {
+            auto& values = group.second[m];
+            if (values.empty())
+            {
+                continue;
+            }
+            double mean = 0;
+            for (auto value : values)
+            {
+                mean += value;
+            }
+            mean /= values.size();
+            double var = 0;
+            for (auto value : values)
+            {
+                var += (value - mean) * (value - mean);
+            }
+            double ci = 0;
+            if (values.size() > 1)
+            {
+                var /= values.size() - 1;
+                ci = GetT95(values.size() - 1) * std::sqrt(var / values.size());
+            }
+            std::sort(values.begin(), values.end());
+            for (auto keyValue : group.first)
+            {
+                out << keyValue << ",";
+            }
+            out << columns[metricIndices[m]] << "," << values.size() << "," << mean << "," << ci
+                << "," << GetPercentile(values, 0.5) << "," << GetPercentile(values, 0.9) << ","
+                << GetPercentile(values, 0.99) << "\n";
+        }
+    }
+    std::clog << numRows << " rows, " << groups.size() << " groups\n";
+    return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EDCA_TRAFFIC_CLIENTS_H
+#define EDCA_TRAFFIC_CLIENTS_H
+
+#include "ns3/bernoulli_packet_socket_client.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/qos-utils.h"
+#include "ns3/uinteger.h"
+
+/**
+ * Traffic clients shared by single-bss-sld-edca and independent-bss-batch.
+ */
+
+/**
+ * Returns an unlimited Bernoulli client: a packet of pktSize bytes with the low TID of linkAc
+ * is generated with probability prob every slot.
+ */
+inline ns3::Ptr<ns3::BernoulliPacketSocketClient>
+GetBernoulliClient(const ns3::PacketSocketAddress& sockAddr,
+                   const std::size_t pktSize,
+                   const double prob,
+                   const ns3::Time& slot,
+                   const ns3::Time& start,
+                   const ns3::AcIndex linkAc)
+{
+    NS_ASSERT(linkAc != ns3::AC_UNDEF);
+    auto tid = ns3::wifiAcList.at(linkAc).GetLowTid();
+
+    auto client = ns3::CreateObject<ns3::BernoulliPacketSocketClient>();
+    client->SetAttribute("PacketSize", ns3::UintegerValue(pktSize));
+    client->SetAttribute("MaxPackets", ns3::UintegerValue(0));
+    client->SetAttribute("TimeSlot", ns3::TimeValue(slot));
+    client->SetAttribute("BernoulliPr", ns3::DoubleValue(prob));
+    client->SetAttribute("Priority", ns3::UintegerValue(tid));
+    client->SetRemote(sockAddr);
+    client->SetStartTime(start);
+    return client;
+}
+
+#endif /* EDCA_TRAFFIC_CLIENTS_H */
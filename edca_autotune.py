@@ -0,0 +1,187 @@
+import argparse
+import csv
+import json
+import os
+import random
+import subprocess
+import signal
+import sys
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+from datetime import datetime
+
+def control_c(signum, frame):
+    print("exiting")
+    sys.exit(1)
+
+signal.signal(signal.SIGINT, control_c)
+
+ACS = ['BE', 'BK', 'VI', 'VO']
+CWMINS = [2, 4, 8, 16, 32, 64, 128, 256, 512, 1024]
+CW_STAGES = list(range(0, 8))
+DEFAULT_CANDIDATE = {'BE': (16, 6), 'BK': (16, 6), 'VI': (8, 4), 'VO': (4, 2)}
+
+# Columns of a wifi-edca.dat row used by the objective, see edca-report.cc for the full layout
+COLUMNS = {'thpt_BK': 6, 'thpt_total': 9, 'e2eDelay_VO': 23, 'e2eDelayP99_VO': 79}
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Successive-halving search of the per-AC CWmin/CwStage of single-bss-sld-edca')
+    parser.add_argument('--candidates', type=int, default=54, help='Candidates screened in the first rung')
+    parser.add_argument('--eta', type=int, default=3,
+                        help='Keep 1/eta of the candidates per rung, simulation time grows by eta')
+    parser.add_argument('--rungs', type=int, default=3, help='Number of rungs')
+    parser.add_argument('--min-time', type=float, default=1.0, help='Simulation time of the first rung (s)')
+    parser.add_argument('--max-time', type=float, default=20.0, help='Simulation time cap (s)')
+    parser.add_argument('--vo-p99', type=float, default=10.0, help='Maximum VO p99 end-to-end delay (ms)')
+    parser.add_argument('--bk-min', type=float, default=0.1, help='Minimum BK throughput (Mbps)')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='Parallel simulations')
+    parser.add_argument('--nSld', type=int, default=8, help='Number of STAs, split evenly over the ACs')
+    parser.add_argument('--lambda', dest='lambda_val', type=float, default=1e-3, help='Per STA arrival rate')
+    parser.add_argument('--seed', type=int, default=1, help='Seed of the candidate sampling')
+    args = parser.parse_args()
+
+    ns3_path = os.path.join('../../../../ns3')
+
+    # Check if the ns3 executable exists
+    if not os.path.exists(ns3_path):
+        print(f"Please run this program from within the correct directory.")
+        sys.exit(1)
+
+    results_dir = os.path.join(os.getcwd(), 'results', f"edca-autotune-{datetime.now().strftime('%Y%m%d-%H%M%S')}")
+    status_dir = os.path.join(results_dir, 'status')
+    os.makedirs(status_dir, exist_ok=True)
+    print(f"Progress of the running simulations: python3 edca_status.py {status_dir} --watch 2")
+
+    # Move to ns3 top-level directory
+    os.chdir('../../../../')
+
+    # Build once, the parallel runs below use --no-build
+    subprocess.run("./ns3 build single-bss-sld-edca", shell=True, check=True)
+
+    rng = random.Random(args.seed)
+    candidates = [DEFAULT_CANDIDATE]
+    while len(candidates) < args.candidates:
+        candidate = {ac: (rng.choice(CWMINS), rng.choice(CW_STAGES)) for ac in ACS}
+        if candidate not in candidates:
+            candidates.append(candidate)
+
+    evaluations = []
+    for rung in range(args.rungs):
+        simulation_time = min(args.min_time * args.eta ** rung, args.max_time)
+        replications = 2 ** rung
+        print(f"Rung {rung}: {len(candidates)} candidates, {simulation_time:g} s, {replications} replications")
+        # every candidate sees the same seeds (common random numbers)
+        jobs = [(candidate, rng_run, os.path.join(status_dir, f"rung{rung}-cand{i}-run{rng_run}.json"))
+                for i, candidate in enumerate(candidates) for rng_run in range(1, replications + 1)]
+        with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+            rows = list(pool.map(lambda job: run_candidate(job[0], job[1], simulation_time, job[2], args), jobs))
+
+        scored = []
+        for i, candidate in enumerate(candidates):
+            candidate_rows = [row for row in rows[i * replications:(i + 1) * replications] if row]
+            if not candidate_rows:
+                continue
+            result = {name: sum(row[index] for row in candidate_rows) / len(candidate_rows)
+                      for name, index in COLUMNS.items() if all(len(row) > index for row in candidate_rows)}
+            result.update({'rung': rung, 'simulation_time': simulation_time,
+                           'replications': len(candidate_rows), 'candidate': candidate})
+            result['feasible'] = is_feasible(result, args)
+            scored.append(result)
+            evaluations.append(result)
+
+        if not scored:
+            print("All runs of the rung failed")
+            sys.exit(1)
+        scored.sort(key=lambda result: score(result, args), reverse=True)
+        if rung < args.rungs - 1:
+            candidates = [result['candidate'] for result in scored[:max(1, len(scored) // args.eta)]]
+
+    write_evaluations(os.path.join(results_dir, 'autotune.csv'), evaluations)
+    front = pareto_front(scored)
+    write_evaluations(os.path.join(results_dir, 'pareto.csv'), front)
+    with open(os.path.join(results_dir, 'autotune-args.json'), 'w') as f:
+        json.dump(vars(args), f, indent=2)
+
+    print(f"Pareto front of the last rung (total thpt, VO p99, BK thpt):")
+    for result in front:
+        print(f"  {format_candidate(result['candidate'])}: {result.get('thpt_total', 0):.3f} Mbps, "
+              f"{result.get('e2eDelayP99_VO', 0):.3f} ms, {result.get('thpt_BK', 0):.3f} Mbps"
+              f"{'' if result['feasible'] else ' (infeasible)'}")
+    best = scored[0]
+    print(f"Best: {format_candidate(best['candidate'])} "
+          f"{'' if best['feasible'] else '(no candidate meets the constraints) '}"
+          f"total {best.get('thpt_total', 0):.3f} Mbps")
+    print(f"Results saved to {results_dir}")
+
+def run_candidate(candidate, rng_run, simulation_time, status_file, args):
+    """
+    Run single-bss-sld-edca once in a temporary directory, publishing its progress to status_file.
+
+    :return: Parsed wifi-edca.dat row, or None if the run failed
+    """
+    num_per_ac = args.nSld // 4
+    cw_args = ' '.join(f"--ac{ac}Cwmin={cwmin} --ac{ac}CwStage={stage}"
+                       for ac, (cwmin, stage) in candidate.items())
+    with tempfile.TemporaryDirectory() as cwd:
+        cmd = (f"./ns3 run --no-build --cwd={cwd} 'single-bss-sld-edca --rngRun={rng_run} "
+               f"--simulationTime={simulation_time} --perSldLambda={args.lambda_val} "
+               f"--nSld={num_per_ac * 4} --nBE={num_per_ac} --nBK={num_per_ac} --nVI={num_per_ac} "
+               f"--nVO={num_per_ac} {cw_args} --statusFile={status_file}'")
+        subprocess.run(cmd, shell=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        edca_dat_file = os.path.join(cwd, 'wifi-edca.dat')
+        if not os.path.exists(edca_dat_file):
+            return None
+        with open(edca_dat_file, 'r') as f:
+            line = f.readline().strip()
+        return [float(token) for token in line.split(',')] if line else None
+
+def is_feasible(result, args):
+    return (result.get('e2eDelayP99_VO', float('inf')) <= args.vo_p99 and
+            result.get('thpt_BK', 0) >= args.bk_min)
+
+def score(result, args):
+    """
+    Feasible candidates rank by total throughput and above all infeasible ones, which rank by
+    how far they are from the constraints.
+    """
+    if result['feasible']:
+        return (1, result.get('thpt_total', 0))
+    violation = (max(0, result.get('e2eDelayP99_VO', float('inf')) / args.vo_p99 - 1) +
+                 max(0, 1 - result.get('thpt_BK', 0) / args.bk_min))
+    return (0, -violation)
+
+def pareto_front(results):
+    """
+    Candidates not dominated in (max total throughput, min VO p99 delay, max BK throughput).
+    """
+    def objectives(result):
+        return (result.get('thpt_total', 0), -result.get('e2eDelayP99_VO', float('inf')),
+                result.get('thpt_BK', 0))
+
+    front = []
+    for result in results:
+        a = objectives(result)
+        dominated = any(all(x >= y for x, y in zip(objectives(other), a)) and objectives(other) != a
+                        for other in results)
+        if not dominated:
+            front.append(result)
+    return sorted(front, key=lambda result: result.get('thpt_total', 0), reverse=True)
+
+def format_candidate(candidate):
+    return ' '.join(f"{ac}={cwmin}/{stage}" for ac, (cwmin, stage) in candidate.items())
+
+def write_evaluations(filename, evaluations):
+    fields = (['rung', 'simulation_time', 'replications'] +
+              [f"ac{ac}{param}" for ac in ACS for param in ['Cwmin', 'CwStage']] +
+              list(COLUMNS) + ['feasible'])
+    with open(filename, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(fields)
+        for result in evaluations:
+            writer.writerow([result['rung'], result['simulation_time'], result['replications']] +
+                            [value for ac in ACS for value in result['candidate'][ac]] +
+                            [result.get(name, '') for name in COLUMNS] + [int(result['feasible'])])
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+import argparse
+import json
+import os
+import subprocess
+import signal
+import sys
+import tempfile
+import time
+from datetime import datetime
+
+def control_c(signum, frame):
+    print("exiting")
+    sys.exit(1)
+
+signal.signal(signal.SIGINT, control_c)
+
+# Fixed benchmark matrix, keep it stable so that results stay comparable with the baseline
+NUM_STAS = [8, 64, 512]
+LAMBDAS = [1e-5, 1e-3, 1e-2]
+TRAFFIC_TYPES = {0: 'deterministic', 1: 'bernoulli'}
+SIMULATION_TIME = 0.5 # stats window, each run also simulates the fixed 5 s warm-up before it
+
+# Metrics gated against the baseline and whether higher values are worse. The wall time of the
+# whole process (total_wall_s, including ns3 start-up and setup) is only reported, except for
+# cases without simulator stats.
+GATED_METRICS = {'wall_s': True, 'events_per_s': False, 'peak_rss_kb': True}
+
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='Performance regression benchmark of the EDCA scenario')
+    parser.add_argument('--baseline', default=os.path.join(script_dir, 'benchmarks', 'edca-baseline.json'),
+                        help='Baseline results to compare against')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='Relative slowdown (wall time or event rate) or peak RSS growth '
+                             'reported as a regression')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='Runs per case, the fastest one is kept')
+    parser.add_argument('--update-baseline', action='store_true',
+                        help='Store the results as the new baseline')
+    args = parser.parse_args()
+
+    ns3_path = os.path.join('../../../../ns3')
+
+    # Check if the ns3 executable exists
+    if not os.path.exists(ns3_path):
+        print(f"Please run this program from within the correct directory.")
+        sys.exit(1)
+
+    results_dir = os.path.join(os.getcwd(), 'results', f"edca-benchmark-{datetime.now().strftime('%Y%m%d-%H%M%S')}")
+    os.makedirs(results_dir, exist_ok=True)
+
+    # Move to ns3 top-level directory
+    os.chdir('../../../../')
+
+    # Build once, the runs below must not include any build time
+    subprocess.run("./ns3 build single-bss-sld-edca get_tauT_tauF_values", shell=True, check=True)
+
+    results = {}
+    for num_STA in NUM_STAS:
+        for lambda_val in LAMBDAS:
+            for traffic_type, traffic_name in TRAFFIC_TYPES.items():
+                case = f"edca/nSld={num_STA}/lambda={lambda_val:g}/{traffic_name}"
+                results[case] = run_case(lambda cwd, stats: run_edca(cwd, stats, num_STA, lambda_val, traffic_type),
+                                         args.repeat)
+                print_case(case, results[case])
+    case = "tauT_tauF"
+    results[case] = run_case(run_tau_values, args.repeat)
+    print_case(case, results[case])
+
+    with open(os.path.join(results_dir, 'benchmark.json'), 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    print(f"Results saved to {os.path.join(results_dir, 'benchmark.json')}")
+
+    if args.update_baseline:
+        os.makedirs(os.path.dirname(args.baseline), exist_ok=True)
+        with open(args.baseline, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+        print(f"Baseline updated: {args.baseline}")
+        return
+
+    if not os.path.exists(args.baseline):
+        print(f"No baseline at {args.baseline}, run with --update-baseline to create it")
+        return
+    with open(args.baseline, 'r') as f:
+        baseline = json.load(f)
+    if compare(results, baseline, args.threshold):
+        sys.exit(1)
+
+def run_edca(cwd, stats_file, num_STA, lambda_val, traffic_type):
+    """
+    Run single-bss-sld-edca once in the given directory. Every case simulates the fixed 5 s
+    warm-up of the scenario followed by SIMULATION_TIME seconds of stats, so the warm-up
+    dominates the cost of the short cases.
+    """
+    num_per_ac = num_STA // 4
+    cmd = (f"./ns3 run --no-build --cwd={cwd} 'single-bss-sld-edca --rngRun=1 "
+           f"--simulationTime={SIMULATION_TIME} --perSldLambda={lambda_val} --nSld={num_STA} "
+           f"--nBE={num_per_ac} --nBK={num_per_ac} --nVI={num_per_ac} --nVO={num_per_ac} "
+           f"--trafficType={traffic_type} --perfStatsFile={stats_file}'")
+    subprocess.run(cmd, shell=True, check=True, stdout=subprocess.DEVNULL)
+
+def run_tau_values(cwd, stats_file):
+    cmd = f"./ns3 run --no-build --cwd={cwd} get_tauT_tauF_values"
+    subprocess.run(cmd, shell=True, check=True, stdout=subprocess.DEVNULL)
+
+def run_case(run, repeat):
+    """
+    Run a benchmark case several times and keep the fastest run (by simulator wall time when
+    the program reports it, total wall time otherwise).
+
+    :param run: Function running the case given a working directory and a stats file
+    :param repeat: Number of runs
+    :return: Dictionary of the metrics of the fastest run
+    """
+    best = None
+    for _ in range(repeat):
+        with tempfile.TemporaryDirectory() as cwd:
+            stats_file = os.path.join(cwd, 'perf-stats.json')
+            start = time.perf_counter()
+            run(cwd, stats_file)
+            metrics = {'total_wall_s': time.perf_counter() - start}
+            # the simulator reports its own run loop time, events and peak RSS
+            if os.path.exists(stats_file):
+                with open(stats_file, 'r') as f:
+                    metrics.update(json.load(f))
+        key = 'wall_s' if 'wall_s' in metrics else 'total_wall_s'
+        if best is None or metrics[key] < best.get(key, float('inf')):
+            best = metrics
+    return best
+
+def print_case(case, metrics):
+    line = f"{case}: {metrics['total_wall_s']:.2f} s"
+    if 'events_per_s' in metrics:
+        line += f", {metrics['events_per_s']:.3g} events/s, {metrics['peak_rss_kb'] / 1024:.1f} MB peak RSS"
+    print(line)
+
+def compare(results, baseline, threshold):
+    """
+    Compare results against the baseline. The simulator wall time, event rate and peak RSS are
+    gated, the total wall time is reported for information.
+
+    :return: True if any case regressed by more than the threshold
+    """
+    regressed = False
+    for case, metrics in sorted(results.items()):
+        if case not in baseline:
+            print(f"{case}: not in baseline")
+            continue
+        gated = dict(GATED_METRICS) if 'wall_s' in metrics else {'total_wall_s': True}
+        for key in ['total_wall_s'] + list(GATED_METRICS):
+            if key not in metrics or not baseline[case].get(key):
+                continue
+            ratio = metrics[key] / baseline[case][key]
+            change = f"{baseline[case][key]:.4g} -> {metrics[key]:.4g} ({(ratio - 1) * 100:+.1f}%)"
+            if key not in gated:
+                print(f"{case} {key}: {change}")
+            elif (ratio > 1 + threshold) if gated[key] else (ratio < 1 - threshold):
+                print(f"REGRESSION {case} {key}: {change}")
+                regressed = True
+    if not regressed:
+        print(f"No regression above {threshold * 100:.0f}%")
+    return regressed
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,107 @@
+import argparse
+import glob
+import json
+import os
+import signal
+import sys
+import time
+
+def control_c(signum, frame):
+    print("exiting")
+    sys.exit(1)
+
+signal.signal(signal.SIGINT, control_c)
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Aggregated view of the --statusFile progress files of running single-bss-sld-edca workers')
+    parser.add_argument('status_dir', help='Directory holding the status files (*.json)')
+    parser.add_argument('--watch', type=float, default=0, help='Refresh period (s), 0 to print once')
+    parser.add_argument('--stale', type=float, default=30,
+                        help='Running workers whose file is older than this (s) are reported as stale')
+    parser.add_argument('--max-delay', type=float, default=0,
+                        help='Flag running workers whose mean delay of any AC exceeds this (ms)')
+    parser.add_argument('--total-runs', type=int, default=0,
+                        help='Number of runs of the sweep, 0 to only estimate the running workers')
+    parser.add_argument('--jobs', type=int, default=1, help='Number of runs executed in parallel')
+    args = parser.parse_args()
+
+    while True:
+        print_status(args)
+        if args.watch <= 0:
+            break
+        time.sleep(args.watch)
+
+def read_status(status_dir):
+    """
+    Read all status files of a directory, skipping files being replaced.
+
+    :return: List of (file name, age of the file in s, status dictionary)
+    """
+    statuses = []
+    now = time.time()
+    for filename in sorted(glob.glob(os.path.join(status_dir, '*.json'))):
+        try:
+            with open(filename, 'r') as f:
+                statuses.append((os.path.basename(filename), now - os.path.getmtime(filename), json.load(f)))
+        except (OSError, ValueError):
+            continue
+    return statuses
+
+def estimate_eta(statuses, total_runs, jobs):
+    """
+    Estimate the wall time left to the end of the sweep.
+
+    The remaining work, in runs, is the runs not started yet plus the unfinished fraction of the
+    running ones. It is spread over the parallel jobs and costs the mean wall time of the finished
+    runs, or the projected wall time of the running ones while no run has finished.
+
+    :param statuses: Status files read by read_status
+    :param total_runs: Number of runs of the sweep, 0 if unknown
+    :param jobs: Number of runs executed in parallel
+    :return: Estimated wall time left (s)
+    """
+    running = [status for _, _, status in statuses if not status['done']]
+    done = [status for _, _, status in statuses if status['done']]
+    if total_runs <= 0:
+        # without the size of the sweep, only the running workers are accounted for
+        return max([status['eta_s'] for status in running], default=0)
+    progress = [min(status['sim_s'] / status['sim_end_s'], 1) if status['sim_end_s'] > 0 else 0
+                for status in running]
+    run_wall_s = [status['wall_s'] for status in done]
+    if not run_wall_s:
+        run_wall_s = [status['wall_s'] / fraction for status, fraction in zip(running, progress)
+                      if fraction > 0]
+    if not run_wall_s:
+        return 0
+    remaining_runs = max(total_runs - len(done) - len(running), 0) + sum(1 - p for p in progress)
+    return remaining_runs / max(jobs, 1) * sum(run_wall_s) / len(run_wall_s)
+
+def print_status(args):
+    statuses = read_status(args.status_dir)
+    running = [entry for entry in statuses if not entry[2]['done']]
+    done = len(statuses) - len(running)
+
+    if args.watch > 0:
+        print("\033[2J\033[H", end='')
+    print(f"{len(running)} running, {done} done"
+          f"{f' of {args.total_runs}' if args.total_runs > 0 else ''}, "
+          f"{sum(entry[2]['events_per_s'] for entry in running):.3g} events/s total, "
+          f"ETA {estimate_eta(statuses, args.total_runs, args.jobs):.0f} s")
+    print(f"{'file':<32} {'sim/end (s)':>12} {'sim/wall':>9} {'ETA (s)':>8} "
+          f"{'thpt BE/BK/VI/VO (Mbps)':>26} {'delay BE/BK/VI/VO (ms)':>26}  flags")
+    for filename, age, status in running:
+        acs = [status['ac'][ac] for ac in ['BE', 'BK', 'VI', 'VO']]
+        flags = []
+        if age > args.stale:
+            flags.append(f"stale {age:.0f}s")
+        if args.max_delay > 0 and any(ac['mean_delay_ms'] > args.max_delay for ac in acs):
+            flags.append("delay")
+        thpts = '/'.join(f"{ac['thpt_mbps']:.2f}" for ac in acs)
+        delays = '/'.join(f"{ac['mean_delay_ms']:.1f}" for ac in acs)
+        print(f"{filename[:32]:<32} {status['sim_s']:>5.1f}/{status['sim_end_s']:<6.1f} "
+              f"{status['sim_per_wall']:>9.3g} {status['eta_s']:>8.0f} "
+              f"{thpts:>26} {delays:>26}  {' '.join(flags)}")
+
+if __name__ == "__main__":
+    main()
@@ -24,6 +24,8 @@ def main():
 
     results_dir = os.path.join(os.getcwd(), 'results', f"{dirname}-{datetime.now().strftime('%Y%m%d-%H%M%S')}")
     os.system('mkdir -p ' + results_dir)
+    status_dir = os.path.join(results_dir, 'status')
+    os.makedirs(status_dir, exist_ok=True)
 
 
     # Move to ns3 top-level directory
@@ -44,185 +46,94 @@ def main():
     min_lambda = -5
     max_lambda = -2
     step_size = 0.5
-    lambdas = []
-    # Run the ns3 simulation for each distance
-    for lam in np.arange(min_lambda, max_lambda + step_size, step_size):
-        lambda_val = 10 ** lam  
-        lambdas.append(lambda_val)
+    lambdas = [10 ** lam for lam in np.arange(min_lambda, max_lambda + step_size, step_size)]
+    print(f"Watch the sweep with: python3 edca_status.py {status_dir} --total-runs {len(lambdas)} --watch 2")
+    # Run the ns3 simulation for each offered load
+    for run, lambda_val in enumerate(lambdas):
         print(lambda_val)
-        cmd = f"./ns3 run 'single-bss-sld-edca --rngRun={rng_run} --payloadSize={max_packets} --perSldLambda={lambda_val} --nSld={num_STA} --nBE={num_BE} --nBK={num_BK} --nVI={num_VI} --nVO={num_VO}'"
+        status_file = os.path.join(status_dir, f"run-{run}.json")
+        cmd = f"./ns3 run 'single-bss-sld-edca --rngRun={rng_run} --payloadSize={max_packets} --perSldLambda={lambda_val} --nSld={num_STA} --nBE={num_BE} --nBK={num_BK} --nVI={num_VI} --nVO={num_VO} --statusFile={status_file}'"
         subprocess.run(cmd, shell=True)
     move_file('wifi-edca.dat', results_dir)
 
-    # Plot the results
+    # Aggregate once with the report tool, the plots below read its table
     edca_dat_file = os.path.join(results_dir, 'wifi-edca.dat')
-    draw_throughput_plot(edca_dat_file, results_dir, lambdas)
-    draw_e2e_delay_plot(edca_dat_file, results_dir, lambdas)
-    draw_acc_delay_plot(edca_dat_file, results_dir, lambdas)
-    draw_queue_delay_plot(edca_dat_file, results_dir, lambdas)
+    report_file = os.path.join(results_dir, 'wifi-edca-report.csv')
+    cmd = f"./ns3 run 'edca-report --input={edca_dat_file} --groupBy=perSldLambda --output={report_file}'"
+    subprocess.run(cmd, shell=True)
+    report = read_report(report_file, 'perSldLambda')
+
+    # Plot the results
+    draw_ac_plot(report, 'thpt', results_dir, 'Throughput vs. Offered Load', 'Throughput (Mbps)',
+                 'wifi-edca-thrp.png', with_total=True)
+    draw_ac_plot(report, 'e2eDelay', results_dir, 'End-to-End Delay vs. Offered Load',
+                 'End-to-End Delay (ms)', 'wifi-edca-delay.png')
+    draw_ac_plot(report, 'accDelay', results_dir, 'Access Delay vs. Offered Load',
+                 'Access Delay (ms)', 'wifi-edca-acc-delay.png')
+    draw_ac_plot(report, 'queDelay', results_dir, 'Queue Delay vs. Offered Load',
+                 'Queue Delay (ms)', 'wifi-edca-queue-delay.png')
     # Save the git commit information
     with open(os.path.join(results_dir, 'git-commit.txt'), 'w') as f:
         commit_info = subprocess.run(['git', 'show', '--name-only'], stdout=subprocess.PIPE)
         f.write(commit_info.stdout.decode())
 
-def draw_throughput_plot(edca_dat_file, results_dir, lambdas):
+def read_report(report_file, group_column):
     """
-    Draw throughput vs. offered load plot from the given data file.
+    Read the table written by edca-report grouped by a single column.
 
-    :param edca_dat_file: Path to the EDCA data file
-    :param results_dir: Directory to save the plot
-    :param lambdas: List of offered load values
+    :param report_file: Path to the report table
+    :param group_column: Column the report is grouped by
+    :return: Dictionary metric -> (x values, means, 95% confidence intervals), sorted by x
     """
-    plt.figure()
-    plt.title('Throughput vs. Offered Load')
-    plt.xlabel('Lambda')
-    plt.ylabel('Throughput (Mbps)')
-    plt.grid()
-    plt.xscale('log')
-    
-    throughput_BE = []
-    throughput_BK = []
-    throughput_VI = []
-    throughput_VO = []
-    throughput_total = []
-    
-    with open(edca_dat_file, 'r') as f:
-        lines = f.readlines()
-        for line in lines:
-            tokens = line.split(',')
-            throughput_BE.append(float(tokens[5]))
-            throughput_BK.append(float(tokens[6]))
-            throughput_VI.append(float(tokens[7]))
-            throughput_VO.append(float(tokens[8]))
-            throughput_total.append(float(tokens[9]))
-    
-    plt.plot(lambdas, throughput_BE, marker='o', label='BE')
-    plt.plot(lambdas, throughput_BK, marker='x', label='BK')
-    plt.plot(lambdas, throughput_VI, marker='o', label='VI')
-    plt.plot(lambdas, throughput_VO, marker='x', label='VO')
-    plt.plot(lambdas, throughput_total, marker='^', label='Total')
-    plt.legend()
-
-    os.makedirs(results_dir, exist_ok=True)
-    plt.savefig(os.path.join(results_dir, 'wifi-edca-thrp.png'))
-    print(f"Plot saved to {os.path.join(results_dir, 'wifi-edca-thrp.png')}")
-
-def draw_e2e_delay_plot(edca_dat_file, results_dir, lambdas):
+    report = {}
+    with open(report_file, 'r') as f:
+        header = f.readline().strip().split(',')
+        x_index = header.index(group_column)
+        metric_index = header.index('metric')
+        mean_index = header.index('mean')
+        ci_index = header.index('ci95')
+        for line in f:
+            tokens = line.strip().split(',')
+            entry = report.setdefault(tokens[metric_index], ([], [], []))
+            entry[0].append(float(tokens[x_index]))
+            entry[1].append(float(tokens[mean_index]))
+            entry[2].append(float(tokens[ci_index]))
+    return report
+
+def draw_ac_plot(report, metric, results_dir, title, ylabel, filename, with_total=False):
     """
-    Draw end-to-end delay vs. offered load plot from the given data file.
+    Draw a per-AC metric vs. offered load plot from the report table.
 
-    :param edca_dat_file: Path to the EDCA data file
+    :param report: Report read by read_report
+    :param metric: Metric prefix, e.g. 'thpt' for thpt_BE ... thpt_VO
     :param results_dir: Directory to save the plot
-    :param lambdas: List of offered load values
+    :param title: Plot title
+    :param ylabel: Y axis label
+    :param filename: Plot file name
+    :param with_total: Also plot the <metric>_total column
     """
     plt.figure()
-    plt.title('End-to-End Delay vs. Offered Load')
+    plt.title(title)
     plt.xlabel('Lambda')
-    plt.ylabel('End-to-End Delay (ms)')
+    plt.ylabel(ylabel)
     plt.grid()
     plt.xscale('log')
-    
-    delay_BE = []
-    delay_BK = []
-    delay_VI = []
-    delay_VO = []
-    
-    with open(edca_dat_file, 'r') as f:
-        lines = f.readlines()
-        for line in lines:
-            tokens = line.split(',')
-            delay_BE.append(float(tokens[20]))
-            delay_BK.append(float(tokens[21]))
-            delay_VI.append(float(tokens[22]))
-            delay_VO.append(float(tokens[23]))
-    
-    plt.plot(lambdas, delay_BE, marker='o', label='BE')
-    plt.plot(lambdas, delay_BK, marker='x', label='BK')
-    plt.plot(lambdas, delay_VI, marker='o', label='VI')
-    plt.plot(lambdas, delay_VO, marker='x', label='VO')
-    plt.legend()
-
-    os.makedirs(results_dir, exist_ok=True)
-    plt.savefig(os.path.join(results_dir, 'wifi-edca-delay.png'))
-    print(f"Plot saved to {os.path.join(results_dir, 'wifi-edca-delay.png')}")
 
-def draw_acc_delay_plot(edca_dat_file, results_dir, lambdas):
-    """
-    Draw access delay vs. offered load plot from the given data file.
-
-    :param edca_dat_file: Path to the EDCA data file
-    :param results_dir: Directory to save the plot
-    :param lambdas: List of offered load values
-    """
-    plt.figure()
-    plt.title('Access Delay vs. Offered Load')
-    plt.xlabel('Lambda')
-    plt.ylabel('Access Delay (ms)')
-    plt.grid()
-    plt.xscale('log')
-    
-    acc_delay_BE = []
-    acc_delay_BK = []
-    acc_delay_VI = []
-    acc_delay_VO = []
-    
-    with open(edca_dat_file, 'r') as f:
-        lines = f.readlines()
-        for line in lines:
-            tokens = line.split(',')
-            acc_delay_BE.append(float(tokens[15]))
-            acc_delay_BK.append(float(tokens[16]))
-            acc_delay_VI.append(float(tokens[17]))
-            acc_delay_VO.append(float(tokens[18]))
-    
-    plt.plot(lambdas, acc_delay_BE, marker='o', label='BE')
-    plt.plot(lambdas, acc_delay_BK, marker='x', label='BK')
-    plt.plot(lambdas, acc_delay_VI, marker='o', label='VI')
-    plt.plot(lambdas, acc_delay_VO, marker='x', label='VO')
-    plt.legend()
-    
-    os.makedirs(results_dir, exist_ok=True)
-    plt.savefig(os.path.join(results_dir, 'wifi-edca-acc-delay.png'))
-    print(f"Plot saved to {os.path.join(results_dir, 'wifi-edca-acc-delay.png')}")
-
-def draw_queue_delay_plot(edca_dat_file, results_dir, lambdas):
-    """
-    Draw queue delay vs. offered load plot from the given data file.
-
-    :param edca_dat_file: Path to the EDCA data file
-    :param results_dir: Directory to save the plot
-    :param lambdas: List of offered load values
-    """
-    plt.figure()
-    plt.title('Queue Delay vs. Offered Load')
-    plt.xlabel('Lambda')
-    plt.ylabel('Queue Delay (ms)')
-    plt.grid()
-    plt.xscale('log')
-    
-    queue_delay_BE = []
-    queue_delay_BK = []
-    queue_delay_VI = []
-    queue_delay_VO = []
-    
-    with open(edca_dat_file, 'r') as f:
-        lines = f.readlines()
-        for line in lines:
-            tokens = line.split(',')
-            queue_delay_BE.append(float(tokens[10]))
-            queue_delay_BK.append(float(tokens[11]))
-            queue_delay_VI.append(float(tokens[12]))
-            queue_delay_VO.append(float(tokens[13]))
-    
-    plt.plot(lambdas, queue_delay_BE, marker='o', label='BE')
-    plt.plot(lambdas, queue_delay_BK, marker='x', label='BK')
-    plt.plot(lambdas, queue_delay_VI, marker='o', label='VI')
-    plt.plot(lambdas, queue_delay_VO, marker='x', label='VO')
+    labels = [('BE', 'o'), ('BK', 'x'), ('VI', 'o'), ('VO', 'x')]
+    if with_total:
+        labels.append(('total', '^'))
+    for ac, marker in labels:
+        name = f"{metric}_{ac}"
+        if name not in report:
+            continue
+        lambdas, means, cis = report[name]
+        plt.errorbar(lambdas, means, yerr=cis, marker=marker, capsize=3,
+                     label='Total' if ac == 'total' else ac)
     plt.legend()
 
     os.makedirs(results_dir, exist_ok=True)
-    plt.savefig(os.path.join(results_dir, 'wifi-edca-queue-delay.png'))
-    print(f"Plot saved to {os.path.join(results_dir, 'wifi-edca-queue-delay.png')}")
+    plt.savefig(os.path.join(results_dir, filename))
+    print(f"Plot saved to {os.path.join(results_dir, filename)}")
 
 def check_and_remove(filename):
     if os.path.exists(filename):
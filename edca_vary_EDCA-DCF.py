@@ -70,114 +70,74 @@ def main():
         move_file('wifi-edca.dat', os.path.join(results_dir, edca_dat_file))
         data_files.append(os.path.join(results_dir, edca_dat_file))
     
-    # Draw throughput plot
-    draw_total_throughput_plot(data_files, results_dir, lambdas, configs)
-    draw_e2e_delay_plot(data_files, results_dir, lambdas, configs)
-    draw_acc_delay_plot(data_files, results_dir, lambdas, configs)
-    draw_queue_delay_plot(data_files, results_dir, lambdas, configs)
-    
+    # Aggregate every configuration once with the report tool, the plots read its tables
+    reports = []
+    for data_file in data_files:
+        report_file = data_file.replace('.dat', '-report.csv')
+        cmd = f"./ns3 run 'edca-report --input={data_file} --groupBy=perSldLambda --output={report_file}'"
+        subprocess.run(cmd, shell=True)
+        reports.append(read_report(report_file, 'perSldLambda'))
+
+    draw_comparison_plot(reports, configs, 'thpt_total', results_dir, 'Total Throughput Comparison',
+                         'Total Throughput (Mbps)', 'wifi-edca-total-throughput-comparison.png')
+    draw_comparison_plot(reports, configs, 'e2eDelay_total', results_dir, 'End-to-End Delay Comparison',
+                         'E2E Delay (ms)', 'wifi-edca-e2e-delay-comparison.png')
+    draw_comparison_plot(reports, configs, 'accDelay_total', results_dir, 'Access Delay Comparison',
+                         'Access Delay (ms)', 'wifi-edca-acc-delay-comparison.png')
+    draw_comparison_plot(reports, configs, 'queDelay_total', results_dir, 'Queue Delay Comparison',
+                         'Queue Delay (ms)', 'wifi-edca-queue-delay-comparison.png')
+
+def read_report(report_file, group_column):
+    """
+    Read the table written by edca-report grouped by a single column.
 
-def draw_total_throughput_plot(data_files, results_dir, lambdas, configs):
+    :param report_file: Path to the report table
+    :param group_column: Column the report is grouped by
+    :return: Dictionary metric -> (x values, means, 95% confidence intervals), sorted by x
+    """
+    report = {}
+    with open(report_file, 'r') as f:
+        header = f.readline().strip().split(',')
+        x_index = header.index(group_column)
+        metric_index = header.index('metric')
+        mean_index = header.index('mean')
+        ci_index = header.index('ci95')
+        for line in f:
+            tokens = line.strip().split(',')
+            entry = report.setdefault(tokens[metric_index], ([], [], []))
+            entry[0].append(float(tokens[x_index]))
+            entry[1].append(float(tokens[mean_index]))
+            entry[2].append(float(tokens[ci_index]))
+    return report
+
+def draw_comparison_plot(reports, configs, metric, results_dir, title, ylabel, filename):
     """
-    Draw total throughput comparison plot.
+    Draw a metric vs. offered load plot with one curve per configuration.
 
-    :param data_files: List of paths to EDCA data files
-    :param results_dir: Directory to save the plot
-    :param lambdas: List of offered load values
+    :param reports: Report of every configuration, read by read_report
     :param configs: Configuration list for labeling
+    :param metric: edca-report metric column, e.g. 'thpt_total'
+    :param results_dir: Directory to save the plot
+    :param title: Plot title
+    :param ylabel: Y axis label
+    :param filename: Plot file name
     """
     plt.figure()
-    plt.title('Total Throughput Comparison')
+    plt.title(title)
     plt.xlabel('Lambda')
-    plt.ylabel('Total Throughput (Mbps)')
+    plt.ylabel(ylabel)
     plt.grid()
     plt.xscale('log')
-    
-    for data_file, config in zip(data_files, configs):
-        throughput_total = []
-        with open(data_file, 'r') as f:
-            lines = f.readlines()
-            for line in lines:
-                tokens = line.split(',')
-                throughput_total.append(float(tokens[9]))  # Index 9 is total throughput
-        
-        plt.plot(lambdas, throughput_total, marker='o', label=config["label"])
-    
-    plt.legend()
-    os.makedirs(results_dir, exist_ok=True)
-    plot_file = os.path.join(results_dir, 'wifi-edca-total-throughput-comparison.png')
-    plt.savefig(plot_file)
-    print(f"Plot saved to {plot_file}")
-
-def draw_e2e_delay_plot(data_files, results_dir, lambdas, configs):
-    plt.figure()
-    plt.title('End-to-End Delay Comparison')
-    plt.xlabel('Lambda')
-    plt.ylabel('E2E Delay (ms)')
-    plt.grid()
-    plt.xscale('log')
-    
-    for data_file, config in zip(data_files, configs):
-        e2e_delay = []
-        with open(data_file, 'r') as f:
-            lines = f.readlines()
-            for line in lines:
-                tokens = line.split(',')
-                e2e_delay.append(float(tokens[24]))  # Adjust index as per the data format
-        
-        plt.plot(lambdas, e2e_delay, marker='o', label=config["label"])
-    
-    plt.legend()
-    os.makedirs(results_dir, exist_ok=True)
-    plot_file = os.path.join(results_dir, 'wifi-edca-e2e-delay-comparison.png')
-    plt.savefig(plot_file)
-    print(f"Plot saved to {plot_file}")
 
-def draw_acc_delay_plot(data_files, results_dir, lambdas, configs):
-    plt.figure()
-    plt.title('Access Delay Comparison')
-    plt.xlabel('Lambda')
-    plt.ylabel('Access Delay (ms)')
-    plt.grid()
-    plt.xscale('log')
-    
-    for data_file, config in zip(data_files, configs):
-        acc_delay = []
-        with open(data_file, 'r') as f:
-            lines = f.readlines()
-            for line in lines:
-                tokens = line.split(',')
-                acc_delay.append(float(tokens[19]))  # Adjust index as per the data format
-        
-        plt.plot(lambdas, acc_delay, marker='o', label=config["label"])
-    
-    plt.legend()
-    os.makedirs(results_dir, exist_ok=True)
-    plot_file = os.path.join(results_dir, 'wifi-edca-acc-delay-comparison.png')
-    plt.savefig(plot_file)
-    print(f"Plot saved to {plot_file}")
+    for report, config in zip(reports, configs):
+        if metric not in report:
+            continue
+        lambdas, means, cis = report[metric]
+        plt.errorbar(lambdas, means, yerr=cis, marker='o', capsize=3, label=config["label"])
 
-def draw_queue_delay_plot(data_files, results_dir, lambdas, configs):
-    plt.figure()
-    plt.title('Queue Delay Comparison')
-    plt.xlabel('Lambda')
-    plt.ylabel('Queue Delay (ms)')
-    plt.grid()
-    plt.xscale('log')
-    
-    for data_file, config in zip(data_files, configs):
-        queue_delay = []
-        with open(data_file, 'r') as f:
-            lines = f.readlines()
-            for line in lines:
-                tokens = line.split(',')
-                queue_delay.append(float(tokens[14]))  # Adjust index as per the data format
-        
-        plt.plot(lambdas, queue_delay, marker='o', label=config["label"])
-    
     plt.legend()
     os.makedirs(results_dir, exist_ok=True)
-    plot_file = os.path.join(results_dir, 'wifi-edca-queue-delay-comparison.png')
+    plot_file = os.path.join(results_dir, filename)
     plt.savefig(plot_file)
     print(f"Plot saved to {plot_file}")
 
@@ -0,0 +1,168 @@
+import json
+import os
+import subprocess
+import shutil
+import signal
+import sys
+from datetime import datetime
+import matplotlib.pyplot as plt
+
+def control_c(signum, frame):
+    print("exiting")
+    sys.exit(1)
+
+signal.signal(signal.SIGINT, control_c)
+
+def main():
+    dirname = 'wifi-edca-dl'
+    ns3_path = os.path.join('../../../../ns3')
+
+    # Check if the ns3 executable exists
+    if not os.path.exists(ns3_path):
+        print(f"Please run this program from within the correct directory.")
+        sys.exit(1)
+
+    results_dir = os.path.join(os.getcwd(), 'results', f"{dirname}-{datetime.now().strftime('%Y%m%d-%H%M%S')}")
+    os.makedirs(results_dir, exist_ok=True)
+
+    # Move to ns3 top-level directory
+    os.chdir('../../../../')
+
+    # Check for existing data files and prompt for removal
+    check_and_remove('wifi-edca.dat')
+    check_and_remove('wifi-edca-dl.dat')
+
+    # Experiment parameters: all ACs downlink, so the AP queues hold one flow per STA
+    rng_run = 1
+    max_packets = 1500
+    simulation_time = 2
+    lambda_val = 1e-4
+    num_STAs = [8, 32, 128, 512]
+
+    # Build once, the runs below use --no-build
+    subprocess.run("./ns3 build single-bss-sld-edca edca-report", shell=True, check=True)
+
+    # wall time of the simulator run loop per simulated second (warm-up included), as reported
+    # by the program itself, i.e. without the ns3 start-up and topology build
+    wall_per_sim_s = []
+    for num_STA in num_STAs:
+        num_per_ac = num_STA // 4
+        print(f"Running downlink simulation with nSld={num_STA}")
+        perf_stats_file = os.path.join(results_dir, f"perf-stats-{num_STA}.json")
+        cmd = (f"./ns3 run --no-build 'single-bss-sld-edca --rngRun={rng_run} "
+               f"--simulationTime={simulation_time} --payloadSize={max_packets} "
+               f"--perSldLambda={lambda_val} --nSld={num_per_ac * 4} --nBE={num_per_ac} "
+               f"--nBK={num_per_ac} --nVI={num_per_ac} --nVO={num_per_ac} "
+               f"--acBEDir=1 --acBKDir=1 --acVIDir=1 --acVODir=1 "
+               f"--perfStatsFile={perf_stats_file}'")
+        subprocess.run(cmd, shell=True, check=True)
+        with open(perf_stats_file, 'r') as f:
+            perf_stats = json.load(f)
+        wall_per_sim_s.append(perf_stats['wall_s'] / perf_stats['sim_s'])
+        print(f"nSld={num_STA}: {perf_stats['wall_s']:.2f} s for {perf_stats['sim_s']:g} simulated s")
+
+    with open(os.path.join(results_dir, 'wall-time.dat'), 'w') as f:
+        for num_STA, wall_time in zip(num_STAs, wall_per_sim_s):
+            f.write(f"{num_STA},{wall_time}\n")
+    move_file('wifi-edca.dat', results_dir)
+    move_file('wifi-edca-dl.dat', results_dir)
+
+    # Aggregate once with the report tool, the throughput plot reads its table
+    edca_dat_file = os.path.join(results_dir, 'wifi-edca.dat')
+    report_file = os.path.join(results_dir, 'wifi-edca-report.csv')
+    cmd = f"./ns3 run --no-build 'edca-report --input={edca_dat_file} --groupBy=nSld --output={report_file}'"
+    subprocess.run(cmd, shell=True, check=True)
+    report = read_report(report_file, 'nSld')
+
+    draw_wall_time_plot(results_dir, num_STAs, wall_per_sim_s)
+    draw_ap_throughput_plot(report, results_dir)
+
+    # Save the git commit information
+    with open(os.path.join(results_dir, 'git-commit.txt'), 'w') as f:
+        commit_info = subprocess.run(['git', 'show', '--name-only'], stdout=subprocess.PIPE)
+        f.write(commit_info.stdout.decode())
+
+def read_report(report_file, group_column):
+    """
+    Read the table written by edca-report grouped by a single column.
+
+    :param report_file: Path to the report table
+    :param group_column: Column the report is grouped by
+    :return: Dictionary metric -> (x values, means, 95% confidence intervals), sorted by x
+    """
+    report = {}
+    with open(report_file, 'r') as f:
+        header = f.readline().strip().split(',')
+        x_index = header.index(group_column)
+        metric_index = header.index('metric')
+        mean_index = header.index('mean')
+        ci_index = header.index('ci95')
+        for line in f:
+            tokens = line.strip().split(',')
+            entry = report.setdefault(tokens[metric_index], ([], [], []))
+            entry[0].append(float(tokens[x_index]))
+            entry[1].append(float(tokens[mean_index]))
+            entry[2].append(float(tokens[ci_index]))
+    return report
+
+def draw_wall_time_plot(results_dir, num_STAs, wall_per_sim_s):
+    """
+    Draw the wall time per simulated second vs. number of downlink destinations.
+
+    :param results_dir: Directory to save the plot
+    :param num_STAs: List of STA counts
+    :param wall_per_sim_s: Run loop wall time per simulated second of each run (s)
+    """
+    plt.figure()
+    plt.title('AP Queue Scaling (all ACs downlink)')
+    plt.xlabel('Number of STAs')
+    plt.ylabel('Wall time per simulated second (s)')
+    plt.grid()
+    plt.xscale('log', base=2)
+    plt.plot(num_STAs, wall_per_sim_s, marker='o')
+
+    os.makedirs(results_dir, exist_ok=True)
+    plt.savefig(os.path.join(results_dir, 'wifi-edca-dl-wall-time.png'))
+    print(f"Plot saved to {os.path.join(results_dir, 'wifi-edca-dl-wall-time.png')}")
+
+def draw_ap_throughput_plot(report, results_dir):
+    """
+    Draw the per-AC throughput sent by the AP vs. number of downlink destinations.
+
+    :param report: Report grouped by nSld, read by read_report
+    :param results_dir: Directory to save the plot
+    """
+    plt.figure()
+    plt.title('Downlink Throughput vs. Number of STAs')
+    plt.xlabel('Number of STAs')
+    plt.ylabel('Throughput (Mbps)')
+    plt.grid()
+    plt.xscale('log', base=2)
+
+    for ac, marker in [('BE', 'o'), ('BK', 'x'), ('VI', 'o'), ('VO', 'x')]:
+        name = f"thpt_{ac}"
+        if name in report:
+            num_STAs, means, cis = report[name]
+            plt.errorbar(num_STAs, means, yerr=cis, marker=marker, capsize=3, label=ac)
+    plt.legend()
+
+    os.makedirs(results_dir, exist_ok=True)
+    plt.savefig(os.path.join(results_dir, 'wifi-edca-dl-thrp.png'))
+    print(f"Plot saved to {os.path.join(results_dir, 'wifi-edca-dl-thrp.png')}")
+
+def check_and_remove(filename):
+    if os.path.exists(filename):
+        response = input(f"Remove existing file {filename}? [Yes/No]: ").strip().lower()
+        if response == 'yes':
+            os.remove(filename)
+            print(f"Removed {filename}")
+        else:
+            print("Exiting...")
+            sys.exit(1)
+
+def move_file(filename, destination_dir):
+    if os.path.exists(filename):
+        shutil.move(filename, destination_dir)
+
+if __name__ == "__main__":
+    main()
@@ -18,63 +18,62 @@ def control_c(signum, frame):
 
 signal.signal(signal.SIGINT, control_c)
 
-def draw_comparison_plots(edca_dat_file_0, edca_dat_file_1, results_dir, lambdas):
+def draw_comparison_plots(edca_dat_file_0, edca_dat_file_1, results_dir):
     """
     Compare throughput and delay between trafficType=0 and trafficType=1.
 
     :param edca_dat_file_0: Data file for trafficType=0
     :param edca_dat_file_1: Data file for trafficType=1
     :param results_dir: Directory to save the plot
-    :param lambdas: List of offered load values
     """
-    throughput_0, delay_0 = extract_metrics(edca_dat_file_0)
-    throughput_1, delay_1 = extract_metrics(edca_dat_file_1)
-
-    # Plot throughput comparison
-    plt.figure()
-    plt.title('Throughput vs. Offered Load (TrafficType=0 and 1)')
-    plt.xlabel('Lambda')
-    plt.ylabel('Throughput (Mbps)')
-    plt.grid()
-    plt.xscale('log')
-    plt.plot(lambdas, throughput_0, marker='o', label='TrafficType=0')
-    plt.plot(lambdas, throughput_1, marker='x', label='TrafficType=1')
-    plt.legend()
-    os.makedirs(results_dir, exist_ok=True)
-    plt.savefig(os.path.join(results_dir, 'wifi-edca-thrp-comparison.png'))
-    print(f"Throughput comparison plot saved to {os.path.join(results_dir, 'wifi-edca-thrp-comparison.png')}")
-
-    # Plot end-to-end delay comparison
-    plt.figure()
-    plt.title('End-to-End Delay vs. Offered Load (TrafficType=0 and 1)')
-    plt.xlabel('Lambda')
-    plt.ylabel('End-to-End Delay (ms)')
-    plt.grid()
-    plt.xscale('log')
-    plt.plot(lambdas, delay_0, marker='o', label='TrafficType=0')
-    plt.plot(lambdas, delay_1, marker='x', label='TrafficType=1')
-    plt.legend()
-    plt.savefig(os.path.join(results_dir, 'wifi-edca-delay-comparison.png'))
-    print(f"End-to-End delay comparison plot saved to {os.path.join(results_dir, 'wifi-edca-delay-comparison.png')}")
-
-def extract_metrics(edca_dat_file):
+    report_0 = run_report(edca_dat_file_0)
+    report_1 = run_report(edca_dat_file_1)
+
+    for metric, title, ylabel, filename in [
+            ('thpt_total', 'Throughput vs. Offered Load (TrafficType=0 and 1)', 'Throughput (Mbps)',
+             'wifi-edca-thrp-comparison.png'),
+            ('e2eDelay_total', 'End-to-End Delay vs. Offered Load (TrafficType=0 and 1)',
+             'End-to-End Delay (ms)', 'wifi-edca-delay-comparison.png')]:
+        plt.figure()
+        plt.title(title)
+        plt.xlabel('Lambda')
+        plt.ylabel(ylabel)
+        plt.grid()
+        plt.xscale('log')
+        for report, marker, label in [(report_0, 'o', 'TrafficType=0'), (report_1, 'x', 'TrafficType=1')]:
+            if metric in report:
+                lambdas, means, cis = report[metric]
+                plt.errorbar(lambdas, means, yerr=cis, marker=marker, capsize=3, label=label)
+        plt.legend()
+        os.makedirs(results_dir, exist_ok=True)
+        plt.savefig(os.path.join(results_dir, filename))
+        print(f"Comparison plot saved to {os.path.join(results_dir, filename)}")
+
+def run_report(edca_dat_file):
     """
-    Extract throughput and delay metrics from the data file.
+    Aggregate a data file with edca-report grouped by offered load and read its table.
 
     :param edca_dat_file: Path to the EDCA data file
-    :return: (throughput, end-to-end delay) as lists
+    :return: Dictionary metric -> (x values, means, 95% confidence intervals), sorted by x
     """
-    throughput = []
-    delay = []
-
-    with open(edca_dat_file, 'r') as f:
-        lines = f.readlines()
-        for line in lines:
-            tokens = line.split(',')
-            throughput.append(float(tokens[9]))  # Total throughput
-            delay.append(float(tokens[19]))  # Average end-to-end delay
-
-    return throughput, delay
+    report_file = edca_dat_file.replace('.dat', '-report.csv')
+    cmd = f"./ns3 run 'edca-report --input={edca_dat_file} --groupBy=perSldLambda --output={report_file}'"
+    subprocess.run(cmd, shell=True)
+
+    report = {}
+    with open(report_file, 'r') as f:
+        header = f.readline().strip().split(',')
+        x_index = header.index('perSldLambda')
+        metric_index = header.index('metric')
+        mean_index = header.index('mean')
+        ci_index = header.index('ci95')
+        for line in f:
+            tokens = line.strip().split(',')
+            entry = report.setdefault(tokens[metric_index], ([], [], []))
+            entry[0].append(float(tokens[x_index]))
+            entry[1].append(float(tokens[mean_index]))
+            entry[2].append(float(tokens[ci_index]))
+    return report
 
 def check_and_remove(filename):
     if os.path.exists(filename):
@@ -144,7 +143,7 @@ def main():
         results_files[trafficType] = output_file
 
     # 画图对比 trafficType=0 和 trafficType=1 的吞吐量和延迟
-    draw_comparison_plots(results_files[0], results_files[1], results_dir, lambda_values)
+    draw_comparison_plots(results_files[0], results_files[1], results_dir)
 
     # 保存当前 Git 提交信息
     with open(os.path.join(results_dir, 'git-commit.txt'), 'w') as f:
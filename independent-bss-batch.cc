@@ -0,0 +1,570 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Batch runner of independent BSSs: a nBssX x nBssY grid of APs, each serving its own uplink
+// STAs of every AC as in single-bss-sld-edca, on 5 GHz channels assigned round robin from
+// channelPlan. Per BSS and AC stats are appended to wifi-edca-bss.dat:
+//   bss,ac,successes,attempts,succPr,thpt,queDelay,accDelay,e2eDelay,channel,width,group,
+//   rank,rngRun,simulationTime,nBss,perSldLambda
+//
+// BSSs interfere when their channels overlap (channels of different numbers or widths may
+// partially overlap) and their APs are closer than interferenceRange. Each connected group of
+// interfering BSSs is one independent simulation with its own spectrum channel. Built with MPI
+// (NS3_MPI), the groups are spread over the ranks (mpirun -np N ./ns3 run independent-bss-batch
+// ...): this batches independent simulations, it does not distribute a shared channel, so a
+// group always runs on a single rank and BSSs that interfere gain nothing from more ranks. The
+// default channelPlan gives every BSS of a 2x2 grid its own 20 MHz channel, hence 4 groups.
+
+#include "edca-config.h"
+#include "edca-traffic-clients.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/double.h"
+#include "ns3/global-value.h"
+#include "ns3/integer.h"
+#include "ns3/log.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-server.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/qos-utils.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/ssid.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-tx-stats-helper.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <list>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+
+#define PI 3.1415926535
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("independent-bss-batch");
+
+// 5 GHz channel of a BSS
+struct BssChannel
+{
+    uint16_t m_number;
+    uint16_t m_width; // MHz
+};
+
+Time slotTime;
+
+/**
+ * Parses a comma separated list of number:width channels, e.g. "36:20,40:20,38:40". Returns
+ * an empty vector if an entry is malformed.
+ */
+std::vector<BssChannel>
+ParseChannelPlan(const std::string& plan)
+{
+    std::vector<BssChannel> channels;
+    std::stringstream planStream(plan);
+    for (std::string item; std::getline(planStream, item, ',');)
+    {
+        auto sep = item.find(':');
+        if (sep == std::string::npos)
+        {
+            return {};
+        }
+        channels.push_back({static_cast<uint16_t>(std::stoul(item.substr(0, sep))),
+                            static_cast<uint16_t>(std::stoul(item.substr(sep + 1)))});
+    }
+    return channels;
+}
+
+bool
+ChannelsOverlap(const BssChannel& a, const BssChannel& b)
+{
+    // channel number n is centered on 5000 + 5n MHz
+    double centerA = 5000 + 5.0 * a.m_number;
+    double centerB = 5000 + 5.0 * b.m_number;
+    return std::abs(centerA - centerB) < (a.m_width + b.m_width) / 2.0;
+}
+
+/**
+ * Returns the interference group of every BSS: the connected components of the graph linking
+ * BSSs on overlapping channels whose APs are closer than range (0 for no distance limit).
+ */
+std::vector<uint32_t>
+GetBssGroups(const std::vector<Vector>& apPositions,
+             const std::vector<BssChannel>& channels,
+             const double range)
+{
+    std::vector<uint32_t> parent(apPositions.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t bss) {
+        while (parent[bss] != bss)
+        {
+            bss = parent[bss] = parent[parent[bss]];
+        }
+        return bss;
+    };
+    for (uint32_t i = 0; i < apPositions.size(); ++i)
+    {
+        for (uint32_t j = i + 1; j < apPositions.size(); ++j)
+        {
+            if (ChannelsOverlap(channels[i], channels[j]) &&
+                (range <= 0 || CalculateDistance(apPositions[i], apPositions[j]) < range))
+            {
+                parent[find(j)] = find(i);
+            }
+        }
+    }
+    // number the groups in order of their first BSS
+    std::vector<uint32_t> groups(apPositions.size());
+    std::map<uint32_t, uint32_t> groupIds;
+    for (uint32_t i = 0; i < apPositions.size(); ++i)
+    {
+        groups[i] = groupIds.emplace(find(i), groupIds.size()).first->second;
+    }
+    return groups;
+}
+
+/**
+ * Assigns every group to a rank, largest groups first to the least loaded rank
+ */
+std::vector<uint32_t>
+AssignGroupsToRanks(const std::vector<uint32_t>& groups, const uint32_t nRanks)
+{
+    uint32_t nGroups = groups.empty() ? 0 : *std::max_element(groups.begin(), groups.end()) + 1;
+    std::vector<uint32_t> sizes(nGroups, 0);
+    for (auto group : groups)
+    {
+        ++sizes[group];
+    }
+    std::vector<uint32_t> order(nGroups);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](uint32_t a, uint32_t b) {
+        return sizes[a] > sizes[b];
+    });
+    std::vector<uint32_t> load(nRanks, 0);
+    std::vector<uint32_t> ranks(nGroups);
+    for (auto group : order)
+    {
+        auto rank = std::min_element(load.begin(), load.end()) - load.begin();
+        ranks[group] = rank;
+        load[rank] += sizes[group];
+    }
+    return ranks;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t rngRun{6};
+    double simulationTime{20}; // seconds
+    uint32_t payloadSize = 1500;
+    int mcs{6};
+    int gi = 800;
+    double apTxPower = 20;
+    double staTxPower = 20;
+
+    // deployment
+    uint32_t nBssX{2};
+    uint32_t nBssY{2};
+    double apDistance{10};        // m between neighbouring APs
+    double staRadius{1};          // m between an AP and its STAs
+    std::string channelPlan{"36:20,40:20,44:20,48:20"};
+    double interferenceRange{0};  // m, 0: overlapping channels always interfere
+
+    // STAs of every BSS
+    std::size_t nBE{1};
+    std::size_t nBK{1};
+    std::size_t nVI{1};
+    std::size_t nVO{1};
+    double perSldLambda{0.00001};
+
+    uint64_t acBECwmin{16};
+    uint8_t acBECwStage{6};
+    uint64_t acBKCwmin{16};
+    uint8_t acBKCwStage{6};
+    uint64_t acVICwmin{8};
+    uint8_t acVICwStage{4};
+    uint64_t acVOCwmin{4};
+    uint8_t acVOCwStage{2};
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Batch runner of independent EDCA BSSs. Under MPI, the ranks simulate disjoint "
+              "groups of interfering BSSs; a group is never split, so BSSs sharing a channel "
+              "run on one rank.");
+    cmd.AddValue("rngRun", "Seed for simulation", rngRun);
+    cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("payloadSize", "Application payload size in Bytes", payloadSize);
+    cmd.AddValue("mcs", "MCS", mcs);
+    cmd.AddValue("nBssX", "Number of APs along x", nBssX);
+    cmd.AddValue("nBssY", "Number of APs along y", nBssY);
+    cmd.AddValue("apDistance", "Distance between neighbouring APs (m)", apDistance);
+    cmd.AddValue("staRadius", "Distance between an AP and its STAs (m)", staRadius);
+    cmd.AddValue("channelPlan",
+                 "Comma separated 5 GHz number:width channels assigned round robin to the BSSs",
+                 channelPlan);
+    cmd.AddValue("interferenceRange",
+                 "AP distance (m) beyond which BSSs are assumed not to interfere, 0 for no "
+                 "limit (BSSs on overlapping channels always share a group)",
+                 interferenceRange);
+    cmd.AddValue("nBE", "Number of AC_BE STAs per BSS", nBE);
+    cmd.AddValue("nBK", "Number of AC_BK STAs per BSS", nBK);
+    cmd.AddValue("nVI", "Number of AC_VI STAs per BSS", nVI);
+    cmd.AddValue("nVO", "Number of AC_VO STAs per BSS", nVO);
+    cmd.AddValue("perSldLambda",
+                 "Per node Bernoulli arrival rate (for Bernoulli traffic)",
+                 perSldLambda);
+    cmd.AddValue("acBECwmin", "Initial CW for AC_BE", acBECwmin);
+    cmd.AddValue("acBECwStage", "Cutoff Stage for AC_BE", acBECwStage);
+    cmd.AddValue("acBKCwmin", "Initial CW for AC_BK", acBKCwmin);
+    cmd.AddValue("acBKCwStage", "Cutoff Stage for AC_BK", acBKCwStage);
+    cmd.AddValue("acVICwmin", "Initial CW for AC_VI", acVICwmin);
+    cmd.AddValue("acVICwStage", "Cutoff Stage for AC_VI", acVICwStage);
+    cmd.AddValue("acVOCwmin", "Initial CW for AC_VO", acVOCwmin);
+    cmd.AddValue("acVOCwStage", "Cutoff Stage for AC_VO", acVOCwStage);
+    cmd.Parse(argc, argv);
+
+    uint32_t rank = 0;
+    uint32_t nRanks = 1;
+#ifdef NS3_MPI
+    // The groups never exchange packets, so there are no remote links and the conservative
+    // lookahead of every rank is unbounded: the ranks only synchronize at the end.
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(&argc, &argv);
+    rank = MpiInterface::GetSystemId();
+    nRanks = MpiInterface::GetSize();
+#endif
+
+    RngSeedManager::SetSeed(rngRun);
+    RngSeedManager::SetRun(rngRun);
+    uint32_t randomStream = rngRun;
+
+    auto channelList = ParseChannelPlan(channelPlan);
+    if (channelList.empty())
+    {
+        std::cout << "wrong channelPlan parameter\n";
+        return 0;
+    }
+
+    // BSS layout, interference groups and their ranks
+    const uint32_t nBss = nBssX * nBssY;
+    std::vector<Vector> apPositions;
+    std::vector<BssChannel> bssChannels;
+    for (uint32_t bss = 0; bss < nBss; ++bss)
+    {
+        apPositions.emplace_back((bss % nBssX) * apDistance, (bss / nBssX) * apDistance, 0.0);
+        bssChannels.push_back(channelList[bss % channelList.size()]);
+    }
+    auto bssGroups = GetBssGroups(apPositions, bssChannels, interferenceRange);
+    auto groupRanks = AssignGroupsToRanks(bssGroups, nRanks);
+    if (rank == 0)
+    {
+        std::clog << nBss << " BSSs in " << groupRanks.size() << " interference groups on "
+                  << nRanks << " ranks\n";
+    }
+
+    std::vector<AcIndex> acList;
+    for (uint32_t i = 0; i < nBK; ++i) acList.push_back(AC_BK);
+    for (uint32_t i = 0; i < nBE; ++i) acList.push_back(AC_BE);
+    for (uint32_t i = 0; i < nVI; ++i) acList.push_back(AC_VI);
+    for (uint32_t i = 0; i < nVO; ++i) acList.push_back(AC_VO);
+
+    // No fragmentation, persistent retransmissions and unlimited queues
+    SetEdcaMacDefaults(payloadSize, Seconds(2 * simulationTime));
+
+    WifiHelper wifiHelp;
+    wifiHelp.SetStandard(WIFI_STANDARD_80211be);
+    std::string dataModeStr = "EhtMcs" + std::to_string(mcs);
+    wifiHelp.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                     "DataMode",
+                                     StringValue(dataModeStr));
+    Ptr<LogDistancePropagationLossModel> lossModel =
+        CreateObject<LogDistancePropagationLossModel>();
+
+    uint64_t beaconInterval = std::min<uint64_t>(
+        (ceil((simulationTime * 1000000) / 1024) * 1024),
+        (65535 * 1024)); // beacon interval needs to be a multiple of time units (1024 us)
+
+    // only the BSSs of the groups of this rank are built
+    struct BssNodes
+    {
+        uint32_t m_bss;
+        Ptr<Node> m_ap;
+        NodeContainer m_stas;
+        NetDeviceContainer m_devices;
+        int64_t m_appStream{0}; // first stream of the applications
+    };
+
+    std::vector<BssNodes> localBss;
+    std::map<uint32_t /* Node ID */, std::pair<uint32_t /* BSS */, AcIndex>> staMap;
+    NodeContainer allNodeCon;
+    NetDeviceContainer allNetDevices;
+    std::map<uint32_t /* group */, Ptr<MultiModelSpectrumChannel>> groupChannels;
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    for (uint32_t bss = 0; bss < nBss; ++bss)
+    {
+        if (groupRanks[bssGroups[bss]] != rank)
+        {
+            continue;
+        }
+        auto& channel = groupChannels[bssGroups[bss]];
+        if (!channel)
+        {
+            channel = CreateObject<MultiModelSpectrumChannel>();
+            channel->AddPropagationLossModel(lossModel);
+        }
+        SpectrumWifiPhyHelper phyHelp;
+        phyHelp.SetChannel(channel);
+        phyHelp.Set("ChannelSettings",
+                    StringValue("{" + std::to_string(bssChannels[bss].m_number) + ", " +
+                                std::to_string(bssChannels[bss].m_width) + ", BAND_5GHZ, 0}"));
+
+        BssNodes nodes{bss, CreateObject<Node>(rank), NodeContainer(), NetDeviceContainer()};
+        nodes.m_stas.Create(acList.size(), rank);
+        Ssid bssSsid = Ssid("BSS-" + std::to_string(bss));
+
+        WifiMacHelper macHelp;
+        macHelp.SetType("ns3::StaWifiMac",
+                        "MaxMissedBeacons",
+                        UintegerValue(std::numeric_limits<uint32_t>::max()),
+                        "Ssid",
+                        SsidValue(bssSsid));
+        phyHelp.Set("TxPowerStart", DoubleValue(staTxPower));
+        phyHelp.Set("TxPowerEnd", DoubleValue(staTxPower));
+        NetDeviceContainer bssDevices = wifiHelp.Install(phyHelp, macHelp, nodes.m_stas);
+
+        macHelp.SetType("ns3::ApWifiMac",
+                        "BeaconInterval",
+                        TimeValue(MicroSeconds(beaconInterval)),
+                        "EnableBeaconJitter",
+                        BooleanValue(false),
+                        "Ssid",
+                        SsidValue(bssSsid));
+        phyHelp.Set("TxPowerStart", DoubleValue(apTxPower));
+        phyHelp.Set("TxPowerEnd", DoubleValue(apTxPower));
+        bssDevices.Add(wifiHelp.Install(phyHelp, macHelp, nodes.m_ap));
+        nodes.m_devices = bssDevices;
+        allNetDevices.Add(bssDevices);
+
+        Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+        const Vector& ap = apPositions[bss];
+        double angle = (static_cast<double>(360) / acList.size());
+        positionAlloc->Add(ap);
+        for (uint32_t i = 0; i < acList.size(); ++i)
+        {
+            positionAlloc->Add(Vector(ap.x + (staRadius * cos((i * angle * PI) / 180)),
+                                      ap.y + (staRadius * sin((i * angle * PI) / 180)),
+                                      0.0));
+            staMap[nodes.m_stas.Get(i)->GetId()] = {bss, acList[i]};
+        }
+        mobility.SetPositionAllocator(positionAlloc);
+        NodeContainer bssNodeCon(nodes.m_ap, nodes.m_stas);
+        mobility.Install(bssNodeCon);
+        allNodeCon.Add(bssNodeCon);
+        localBss.push_back(nodes);
+    }
+
+    // Every BSS has the same devices, hence uses as many streams, as counted by AssignStreams
+    // on the first local one (plus the start time variable). The streams of BSS b start at
+    // b times that count, so that a BSS draws the same numbers whatever the rank count.
+    int64_t streamsPerBss = 0;
+    if (!localBss.empty())
+    {
+        streamsPerBss = WifiHelper::AssignStreams(localBss.front().m_devices, randomStream) + 1;
+    }
+    for (auto& nodes : localBss)
+    {
+        int64_t stream = randomStream + nodes.m_bss * streamsPerBss;
+        int64_t used = WifiHelper::AssignStreams(nodes.m_devices, stream);
+        NS_ABORT_MSG_IF(used + 1 != streamsPerBss,
+                        "BSS " << nodes.m_bss << " uses " << used << " streams instead of "
+                               << streamsPerBss - 1);
+        nodes.m_appStream = stream + used;
+    }
+
+    if (!localBss.empty())
+    {
+        Config::Set("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/HeConfiguration/GuardInterval",
+                    TimeValue(NanoSeconds(gi)));
+
+        // CWs of every AC on both APs and STAs, AIFSNs and TXOP limits as in single-bss-sld-edca
+        std::map<AcIndex, std::list<uint64_t>> minCwsMap;
+        std::map<AcIndex, std::list<uint64_t>> maxCwsMap;
+        for (const auto& [ac, cwmin, cwStage] : {std::make_tuple(AC_BE, acBECwmin, acBECwStage),
+                                                 std::make_tuple(AC_BK, acBKCwmin, acBKCwStage),
+                                                 std::make_tuple(AC_VI, acVICwmin, acVICwStage),
+                                                 std::make_tuple(AC_VO, acVOCwmin, acVOCwStage)})
+        {
+            minCwsMap[ac] = {cwmin - 1};
+            maxCwsMap[ac] = {static_cast<uint64_t>(cwmin * pow(2, cwStage)) - 1};
+        }
+        SetEdcaParameters(minCwsMap, maxCwsMap);
+
+        auto staWifiManager = DynamicCast<ConstantRateWifiManager>(
+            DynamicCast<WifiNetDevice>(localBss.front().m_stas.Get(0)->GetDevice(0))
+                ->GetRemoteStationManager());
+        slotTime = staWifiManager->GetPhy()->GetSlot();
+    }
+
+    // uplink Bernoulli traffic from every STA to its AP
+    PacketSocketHelper packetSocket;
+    packetSocket.Install(allNodeCon);
+    for (const auto& nodes : localBss)
+    {
+        Ptr<UniformRandomVariable> startTime = CreateObject<UniformRandomVariable>();
+        startTime->SetAttribute("Stream", IntegerValue(nodes.m_appStream));
+        startTime->SetAttribute("Min", DoubleValue(0.0));
+        startTime->SetAttribute("Max", DoubleValue(1.0));
+
+        auto apDevice = DynamicCast<WifiNetDevice>(nodes.m_ap->GetDevice(0));
+        PacketSocketAddress srvAddr;
+        srvAddr.SetSingleDevice(apDevice->GetIfIndex());
+        srvAddr.SetProtocol(1);
+        auto psServer = CreateObject<PacketSocketServer>();
+        psServer->SetLocal(srvAddr);
+        nodes.m_ap->AddApplication(psServer);
+        psServer->SetStartTime(Seconds(0));
+
+        for (uint32_t i = 0; i < nodes.m_stas.GetN(); ++i)
+        {
+            auto staDevice = DynamicCast<WifiNetDevice>(nodes.m_stas.Get(i)->GetDevice(0));
+            PacketSocketAddress sockAddr;
+            sockAddr.SetSingleDevice(staDevice->GetIfIndex());
+            sockAddr.SetPhysicalAddress(apDevice->GetAddress());
+            sockAddr.SetProtocol(1);
+            nodes.m_stas.Get(i)->AddApplication(GetBernoulliClient(sockAddr,
+                                                                   payloadSize,
+                                                                   perSldLambda,
+                                                                   slotTime,
+                                                                   Seconds(startTime->GetValue()),
+                                                                   acList[i]));
+        }
+    }
+
+    WifiTxStatsHelper wifiTxStats;
+    wifiTxStats.Enable(allNetDevices);
+    wifiTxStats.Start(Seconds(5));
+    wifiTxStats.Stop(Seconds(5 + simulationTime));
+
+    Simulator::Stop(Seconds(5 + simulationTime));
+    Simulator::Run();
+
+    // per BSS and AC stats, delays as in single-bss-sld-edca: the first MPDU of a STA is left
+    // out of the delay sums, which are still divided by the number of successes
+    struct BssAcStats
+    {
+        uint64_t m_successes{0};
+        uint64_t m_attempts{0};
+        long double m_queDelay{0};
+        long double m_accDelay{0};
+    };
+
+    std::map<uint32_t /* BSS */, std::map<AcIndex, BssAcStats>> bssStatsMap;
+    auto successInfo = wifiTxStats.GetSuccessInfoMap();
+    for (const auto& nodeMap : successInfo)
+    {
+        auto staIt = staMap.find(nodeMap.first);
+        if (staIt == staMap.end())
+        {
+            continue; // AP
+        }
+        auto& stats = bssStatsMap[staIt->second.first][staIt->second.second];
+        for (const auto& linkMap : nodeMap.second)
+        {
+            double prevDequeue = 0;
+            bool first = true;
+            for (const auto& record : linkMap.second)
+            {
+                ++stats.m_successes;
+                stats.m_attempts += 1 + record.m_failures;
+                if (!first)
+                {
+                    double hol = std::max(record.m_enqueueMs, prevDequeue);
+                    stats.m_queDelay += hol - record.m_enqueueMs;
+                    stats.m_accDelay += record.m_dequeueMs - hol;
+                }
+                prevDequeue = record.m_dequeueMs;
+                first = false;
+            }
+        }
+    }
+
+    std::stringstream rows;
+    for (const auto& nodes : localBss)
+    {
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            const auto& stats = bssStatsMap[nodes.m_bss][ac];
+            double successes = std::max<uint64_t>(stats.m_successes, 1);
+            double queDelay = stats.m_queDelay / successes;
+            double accDelay = stats.m_accDelay / successes;
+            rows << nodes.m_bss << "," << +ac << "," << stats.m_successes << ","
+                 << stats.m_attempts << ","
+                 << (stats.m_attempts > 0
+                         ? static_cast<double>(stats.m_successes) / stats.m_attempts
+                         : 0.0)
+                 << ","
+                 << static_cast<long double>(stats.m_successes) * payloadSize * 8 /
+                        simulationTime / 1000000
+                 << "," << queDelay << "," << accDelay << "," << queDelay + accDelay << ","
+                 << bssChannels[nodes.m_bss].m_number << "," << bssChannels[nodes.m_bss].m_width
+                 << "," << bssGroups[nodes.m_bss] << "," << rank << "," << rngRun << ","
+                 << simulationTime << "," << nBss << "," << perSldLambda << "\n";
+        }
+    }
+
+    // the ranks append their rows in turn
+    for (uint32_t turn = 0; turn < nRanks; ++turn)
+    {
+        if (turn == rank)
+        {
+            std::ofstream bssFileSummary("wifi-edca-bss.dat", std::ofstream::app);
+            bssFileSummary << rows.str();
+        }
+#ifdef NS3_MPI
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    }
+
+    Simulator::Destroy();
+#ifdef NS3_MPI
+    MpiInterface::Disable();
+#endif
+    return 0;
+}
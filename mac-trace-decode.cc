@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Decodes the binary MAC event trace of single-bss-sld-edca (--macTraceFile) into CSV
+// (time_ns,node,event,ac,link,arg,projected_ns), or prints per node/AC event counts with
+// --summary. projected_ns is only set on AIFS_PROJECTED rows: it is the end of AIFS as projected
+// when the backoff was drawn, not an observed channel access time.
+
+#include "edca-mac-trace.h"
+
+#include "ns3/command-line.h"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <map>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input{"single-bss-sld.mactrace"};
+    int64_t nodeFilter{-1};
+    bool sortByTime{false};
+    bool summary{false};
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Binary MAC trace", input);
+    cmd.AddValue("node", "Only decode the events of this node (-1: all)", nodeFilter);
+    cmd.AddValue("sort", "Sort all events by time (loads the trace in memory)", sortByTime);
+    cmd.AddValue("summary", "Print event counts per node and AC instead of events", summary);
+    cmd.Parse(argc, argv);
+
+    std::FILE* in = std::fopen(input.c_str(), "rb");
+    if (!in)
+    {
+        std::cout << "cannot open " << input << "\n";
+        return 1;
+    }
+    MacTraceFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, in) != 1 ||
+        std::memcmp(header.m_magic, MAC_TRACE_MAGIC, sizeof(header.m_magic)) != 0 ||
+        header.m_version != MAC_TRACE_VERSION || header.m_recordSize != sizeof(MacTraceRecord))
+    {
+        std::cout << input << " is not a MAC trace\n";
+        std::fclose(in);
+        return 1;
+    }
+
+    const char* acNames[] = {"BE", "BK", "VI", "VO"};
+    auto print = [&acNames](const MacTraceRecord& record) {
+        std::cout << record.m_timeNs << "," << record.m_nodeId << ","
+                  << GetMacTraceEventName(record.m_event) << ","
+                  << (record.m_ac < 4 ? acNames[record.m_ac] : "-") << ",";
+        if (record.m_linkId == MAC_TRACE_NO_LINK)
+        {
+            std::cout << "-";
+        }
+        else
+        {
+            std::cout << +record.m_linkId;
+        }
+        std::cout << "," << record.m_arg << ",";
+        if (record.m_event == MAC_TRACE_AIFS_PROJECTED)
+        {
+            std::cout << record.m_timeNs + record.m_arg;
+        }
+        std::cout << "\n";
+    };
+
+    std::map<std::pair<uint32_t, uint8_t>, std::array<uint64_t, MAC_TRACE_NUM_EVENTS>> counts;
+    std::vector<MacTraceRecord> sorted;
+    std::vector<MacTraceRecord> batch(4096);
+    std::size_t count;
+    if (!summary && !sortByTime)
+    {
+        std::cout << "time_ns,node,event,ac,link,arg,projected_ns\n";
+    }
+    while ((count = std::fread(batch.data(), sizeof(MacTraceRecord), batch.size(), in)) > 0)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& record = batch[i];
+            if (nodeFilter >= 0 && record.m_nodeId != nodeFilter)
+            {
+                continue;
+            }
+            if (summary)
+            {
+                if (record.m_event < MAC_TRACE_NUM_EVENTS)
+                {
+                    ++counts[{record.m_nodeId, record.m_ac}][record.m_event];
+                }
+            }
+            else if (sortByTime)
+            {
+                sorted.push_back(record);
+            }
+            else
+            {
+                print(record);
+            }
+        }
+    }
+    std::fclose(in);
+
+    if (summary)
+    {
+        std::cout << "node,ac";
+        for (uint8_t event = 0; event < MAC_TRACE_NUM_EVENTS; ++event)
+        {
+            std::cout << "," << GetMacTraceEventName(event);
+        }
+        std::cout << "\n";
+        for (const auto& entry : counts)
+        {
+            std::cout << entry.first.first << ","
+                      << (entry.first.second < 4 ? acNames[entry.first.second] : "-");
+            for (auto eventCount : entry.second)
+            {
+                std::cout << "," << eventCount;
+            }
+            std::cout << "\n";
+        }
+    }
+    else if (sortByTime)
+    {
+        std::stable_sort(sorted.begin(),
+                         sorted.end(),
+                         [](const MacTraceRecord& a, const MacTraceRecord& b) {
+                             return a.m_timeNs < b.m_timeNs;
+                         });
+        std::cout << "time_ns,node,event,ac,link,arg,projected_ns\n";
+        for (const auto& record : sorted)
+        {
+            print(record);
+        }
+    }
+    return 0;
+}
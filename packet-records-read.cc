@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Reads the per-packet records of single-bss-sld-edca (--packetRecordFile) and recomputes
+// the delay metrics per AC (or per node and AC with --perNode, per link with --perLink):
+//   node,ac,link,successes,attempts,succPr,queDelay,accDelay,e2eDelay,e2eP50,e2eP99
+// Delays are in ms, queuing delay is enqueue -> head of line and access delay is head of
+// line -> dequeue, as in single-bss-sld-edca: the head of line is taken on the queue shared by
+// the links of a node and AC, and the delays are attributed to the link that delivered the MPDU.
+// --csv dumps the records instead.
+
+#include "edca-packet-records.h"
+
+#include "ns3/command-line.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <tuple>
+
+using namespace ns3;
+
+namespace
+{
+
+struct DelayStats
+{
+    uint64_t m_successes{0};
+    uint64_t m_attempts{0};
+    long double m_queDelayMs{0};
+    long double m_accDelayMs{0};
+    std::vector<double> m_e2eDelaysMs;
+};
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string input{"single-bss-sld.pktrec"};
+    bool perNode{false};
+    bool perLink{false};
+    bool csv{false};
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Binary packet record file", input);
+    cmd.AddValue("perNode", "Report per node and AC instead of per AC", perNode);
+    cmd.AddValue("perLink", "Also split the report per link", perLink);
+    cmd.AddValue("csv", "Dump the records as CSV instead of the metrics", csv);
+    cmd.Parse(argc, argv);
+
+    std::FILE* in = std::fopen(input.c_str(), "rb");
+    if (!in)
+    {
+        std::cout << "cannot open " << input << "\n";
+        return 1;
+    }
+    PacketRecordFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, in) != 1 ||
+        std::memcmp(header.m_magic, PACKET_RECORD_MAGIC, sizeof(header.m_magic)) != 0 ||
+        header.m_version != PACKET_RECORD_VERSION)
+    {
+        std::cout << input << " is not a packet record file\n";
+        std::fclose(in);
+        return 1;
+    }
+
+    const char* acNames[] = {"BE", "BK", "VI", "VO"};
+    std::map<std::pair<uint32_t, uint8_t>, uint64_t> lastDequeueNs; // head of line reference
+    std::map<std::tuple<int64_t, uint8_t, int>, DelayStats> statsMap; // node, AC, link
+    std::vector<uint8_t> payload;
+    std::vector<PacketRecord> records;
+    PacketRecordBlockHeader block;
+    if (csv)
+    {
+        std::cout << "node,ac,link,enqueue_ns,hol_ns,dequeue_ns,failures,dst\n";
+    }
+    while (std::fread(&block, sizeof(block), 1, in) == 1)
+    {
+        payload.resize(block.m_payloadSize);
+        if (std::fread(payload.data(), 1, payload.size(), in) != payload.size() ||
+            !DecodePacketRecords(payload.data(), payload.size(), block.m_numRecords, records))
+        {
+            std::cout << input << ": truncated or corrupt block of node " << block.m_nodeId
+                      << "\n";
+            std::fclose(in);
+            return 1;
+        }
+        const std::pair<uint32_t, uint8_t> stream{block.m_nodeId, block.m_ac};
+        auto lastIt = lastDequeueNs.find(stream);
+        for (const auto& record : records)
+        {
+            // the previous dequeue of the first MPDU of a node and AC is unknown, so its head
+            // of line time is taken as its enqueue time
+            bool first = (lastIt == lastDequeueNs.end());
+            if (first)
+            {
+                lastIt = lastDequeueNs.emplace(stream, record.m_enqueueNs).first;
+            }
+            uint64_t holNs = std::max(record.m_enqueueNs, lastIt->second);
+            lastIt->second = record.m_dequeueNs;
+            if (csv)
+            {
+                std::cout << block.m_nodeId << ","
+                          << (block.m_ac < 4 ? acNames[block.m_ac] : "-") << ","
+                          << +record.m_linkId << "," << record.m_enqueueNs << "," << holNs
+                          << "," << record.m_dequeueNs << "," << record.m_failures << ","
+                          << record.m_dst << "\n";
+                continue;
+            }
+            // as in single-bss-sld-edca, the first MPDU of a node and AC is left out of the
+            // metrics: it may have been queued before the stats started
+            if (first)
+            {
+                continue;
+            }
+            auto& stats = statsMap[{perNode ? static_cast<int64_t>(block.m_nodeId) : -1,
+                                    block.m_ac,
+                                    perLink ? record.m_linkId : -1}];
+            ++stats.m_successes;
+            stats.m_attempts += 1 + record.m_failures;
+            stats.m_queDelayMs += (holNs - record.m_enqueueNs) / 1e6;
+            stats.m_accDelayMs += (record.m_dequeueNs - holNs) / 1e6;
+            stats.m_e2eDelaysMs.push_back((record.m_dequeueNs - record.m_enqueueNs) / 1e6);
+        }
+    }
+    std::fclose(in);
+    if (csv)
+    {
+        return 0;
+    }
+
+    std::cout
+        << "node,ac,link,successes,attempts,succPr,queDelay,accDelay,e2eDelay,e2eP50,e2eP99\n";
+    for (auto& entry : statsMap)
+    {
+        auto& stats = entry.second;
+        if (stats.m_successes == 0)
+        {
+            continue;
+        }
+        auto percentile = [&stats](double p) {
+            auto& delays = stats.m_e2eDelaysMs;
+            auto rank = std::min<std::size_t>(std::ceil(p * delays.size()), delays.size()) - 1;
+            std::nth_element(delays.begin(), delays.begin() + rank, delays.end());
+            return delays[rank];
+        };
+        const auto [node, ac, link] = entry.first;
+        if (node < 0)
+        {
+            std::cout << "all";
+        }
+        else
+        {
+            std::cout << node;
+        }
+        std::cout << "," << (ac < 4 ? acNames[ac] : "-") << ",";
+        if (link < 0)
+        {
+            std::cout << "all";
+        }
+        else
+        {
+            std::cout << link;
+        }
+        std::cout << "," << stats.m_successes << "," << stats.m_attempts << ","
+                  << static_cast<double>(stats.m_successes) / stats.m_attempts << ","
+                  << static_cast<double>(stats.m_queDelayMs / stats.m_successes) << ","
+                  << static_cast<double>(stats.m_accDelayMs / stats.m_successes) << ","
+                  << static_cast<double>((stats.m_queDelayMs + stats.m_accDelayMs) /
+                                         stats.m_successes)
+                  << "," << percentile(0.5) << "," << percentile(0.99) << "\n";
+    }
+    return 0;
+}
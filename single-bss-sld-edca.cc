@@ -16,15 +16,23 @@
  *
  */
 
-#include "ns3/attribute-container.h"
-#include "ns3/bernoulli_packet_socket_client.h"
+#include "edca-config.h"
+#include "edca-mac-trace.h"
+#include "edca-packet-records.h"
+#include "edca-traffic-clients.h"
+#include "trace-replay-format.h"
+
+#include "ns3/application.h"
+#include "ns3/channel-access-manager.h"
 #include "ns3/command-line.h"
 #include "ns3/config.h"
 #include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/double.h"
 #include "ns3/eht-configuration.h"
 #include "ns3/eht-phy.h"
 #include "ns3/frame-exchange-manager.h"
 #include "ns3/internet-stack-helper.h"
+#include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/multi-model-spectrum-channel.h"
@@ -33,20 +41,41 @@
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
 #include "ns3/packet-socket-server.h"
+#include "ns3/qos-txop.h"
 #include "ns3/qos-utils.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
 #include "ns3/spectrum-wifi-helper.h"
+#include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/wifi-mac-queue.h"
+#include "ns3/wifi-mpdu.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/wifi-phy-common.h"
 #include "ns3/wifi-phy.h"
+#include "ns3/wifi-psdu.h"
 #include "ns3/wifi-tx-stats-helper.h"
 #include "ns3/wifi-utils.h"
 #include "ns3/yans-wifi-helper.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
 
 #define PI 3.1415926535
 
@@ -58,9 +87,28 @@ enum TrafficTypeEnum
 {
     TRAFFIC_DETERMINISTIC,
     TRAFFIC_BERNOULLI,
+    TRAFFIC_TRACE,
+    TRAFFIC_BURSTY,
     TRAFFIC_INVALID
 };
 
+enum BurstSizeModelEnum
+{
+    BURST_GEOMETRIC,
+    BURST_POISSON
+};
+
+// Largest mean burst size, the burst size draws cost O(mean) uniform variables
+constexpr double MAX_MEAN_BURST_SIZE = 1000;
+
+// Per AC compound arrival config (TRAFFIC_BURSTY)
+struct BurstConfig
+{
+    double m_meanBurstSize; // mean number of packets per arrival event
+    double m_meanOnMs;      // mean ON period, 0 for no ON/OFF modulation
+    double m_meanOffMs;     // mean OFF period
+};
+
 // Per SLD traffic config
 struct TrafficConfig
 {
@@ -69,51 +117,1234 @@ struct TrafficConfig
     AcIndex m_linkAc; 
     double m_lambda;
     double m_determIntervalNs;
+    std::string m_traceFile; // only used by TRAFFIC_TRACE
+    BurstConfig m_burst;     // only used by TRAFFIC_BURSTY
 };
 
 using TrafficConfigMap = std::map<uint32_t /* Node ID */, TrafficConfig>;
 
-Time slotTime;
+Time slotTime;
+
+/**
+ * Client that replays the arrivals of a memory-mapped trace file (see trace-replay-format.h).
+ * Only the next arrival is scheduled at any time, and pages of the trace that have been
+ * replayed are handed back to the kernel, so traces much larger than memory can be used.
+ */
+class TraceReplayPacketSocketClient : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    TraceReplayPacketSocketClient();
+    ~TraceReplayPacketSocketClient() override;
+
+    void SetRemote(PacketSocketAddress addr);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void MapTrace();
+    void UnmapTrace();
+    void ScheduleNext();
+    void Send();
+
+    std::string m_traceFile;
+    void* m_map{MAP_FAILED};
+    std::size_t m_mapSize{0};
+    const TraceReplayRecord* m_records{nullptr};
+    uint64_t m_numRecords{0};
+    uint64_t m_next{0};     // index of the next record to replay
+    uint64_t m_released{0}; // records whose pages have been released
+    Time m_replayStart;
+
+    Ptr<Socket> m_socket;
+    PacketSocketAddress m_peerAddress;
+    bool m_peerAddressSet{false};
+    EventId m_sendEvent;
+    uint64_t m_sent{0};
+    uint64_t m_sendFailures{0}; // records rejected by the socket, e.g. larger than the MTU
+
+    TracedCallback<Ptr<const Packet>, const Address&> m_txTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TraceReplayPacketSocketClient);
+
+TypeId
+TraceReplayPacketSocketClient::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TraceReplayPacketSocketClient")
+            .SetParent<Application>()
+            .AddConstructor<TraceReplayPacketSocketClient>()
+            .AddAttribute("TraceFile",
+                          "Binary arrival trace replayed by this client",
+                          StringValue(""),
+                          MakeStringAccessor(&TraceReplayPacketSocketClient::m_traceFile),
+                          MakeStringChecker())
+            .AddTraceSource("Tx",
+                            "A packet has been sent",
+                            MakeTraceSourceAccessor(&TraceReplayPacketSocketClient::m_txTrace),
+                            "ns3::Packet::AddressTracedCallback");
+    return tid;
+}
+
+TraceReplayPacketSocketClient::TraceReplayPacketSocketClient()
+{
+}
+
+TraceReplayPacketSocketClient::~TraceReplayPacketSocketClient()
+{
+    UnmapTrace();
+}
+
+void
+TraceReplayPacketSocketClient::SetRemote(PacketSocketAddress addr)
+{
+    m_peerAddress = addr;
+    m_peerAddressSet = true;
+}
+
+void
+TraceReplayPacketSocketClient::DoDispose()
+{
+    UnmapTrace();
+    m_socket = nullptr;
+    Application::DoDispose();
+}
+
+void
+TraceReplayPacketSocketClient::MapTrace()
+{
+    int fd = open(m_traceFile.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "cannot open trace file " << m_traceFile);
+    struct stat st;
+    NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "cannot stat trace file " << m_traceFile);
+    m_mapSize = static_cast<std::size_t>(st.st_size);
+    NS_ABORT_MSG_IF(m_mapSize < sizeof(TraceReplayFileHeader),
+                    "trace file " << m_traceFile << " is truncated");
+    m_map = mmap(nullptr, m_mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(m_map == MAP_FAILED, "cannot mmap trace file " << m_traceFile);
+    madvise(m_map, m_mapSize, MADV_SEQUENTIAL);
+
+    const auto header = static_cast<const TraceReplayFileHeader*>(m_map);
+    NS_ABORT_MSG_IF(!IsValidTraceReplayHeader(*header),
+                    "trace file " << m_traceFile << " has an invalid header");
+    // a corrupt record count must not overflow the size check
+    NS_ABORT_MSG_IF(header->m_numRecords >
+                        (m_mapSize - sizeof(TraceReplayFileHeader)) / sizeof(TraceReplayRecord),
+                    "trace file " << m_traceFile << " is truncated");
+    m_numRecords = header->m_numRecords;
+    m_records = reinterpret_cast<const TraceReplayRecord*>(static_cast<const char*>(m_map) +
+                                                           sizeof(TraceReplayFileHeader));
+    m_next = 0;
+    m_released = 0;
+}
+
+void
+TraceReplayPacketSocketClient::UnmapTrace()
+{
+    if (m_map != MAP_FAILED)
+    {
+        munmap(m_map, m_mapSize);
+        m_map = MAP_FAILED;
+    }
+    m_records = nullptr;
+    m_numRecords = 0;
+}
+
+void
+TraceReplayPacketSocketClient::StartApplication()
+{
+    NS_ASSERT_MSG(m_peerAddressSet, "Peer address not set");
+    if (!m_socket)
+    {
+        TypeId tid = TypeId::LookupByName("ns3::PacketSocketFactory");
+        m_socket = Socket::CreateSocket(GetNode(), tid);
+        m_socket->Bind(m_peerAddress);
+        m_socket->Connect(m_peerAddress);
+    }
+    m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+
+    MapTrace();
+    m_replayStart = Simulator::Now();
+    ScheduleNext();
+}
+
+void
+TraceReplayPacketSocketClient::StopApplication()
+{
+    Simulator::Cancel(m_sendEvent);
+    if (m_socket)
+    {
+        m_socket->Close();
+    }
+    UnmapTrace();
+    if (m_sendFailures > 0)
+    {
+        std::clog << "trace file " << m_traceFile << ": " << m_sendFailures << " of "
+                  << m_sent + m_sendFailures << " packets rejected by the socket (larger than "
+                  << "the MTU?)\n";
+    }
+}
+
+void
+TraceReplayPacketSocketClient::ScheduleNext()
+{
+    if (m_next >= m_numRecords)
+    {
+        return;
+    }
+    // release the pages already replayed every 1M records (12 MB), keeping the RSS flat
+    if (m_next - m_released >= (1 << 20))
+    {
+        const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto begin = reinterpret_cast<uintptr_t>(m_map);
+        const auto end = reinterpret_cast<uintptr_t>(m_records + m_next) & ~(pageSize - 1);
+        madvise(m_map, end - begin, MADV_DONTNEED);
+        m_released = m_next;
+    }
+    Time arrival = m_replayStart + NanoSeconds(m_records[m_next].m_timeNs);
+    m_sendEvent = Simulator::Schedule(std::max(arrival - Simulator::Now(), Time(0)),
+                                      &TraceReplayPacketSocketClient::Send,
+                                      this);
+}
+
+void
+TraceReplayPacketSocketClient::Send()
+{
+    // all the records sharing the current timestamp are sent in this event
+    const uint64_t nowNs = (Simulator::Now() - m_replayStart).GetNanoSeconds();
+    do
+    {
+        const auto& record = m_records[m_next++];
+        m_socket->SetPriority(record.m_tid);
+        Ptr<Packet> packet = Create<Packet>(record.m_size);
+        if (m_socket->Send(packet) >= 0)
+        {
+            m_txTrace(packet, m_peerAddress);
+            ++m_sent;
+        }
+        else
+        {
+            ++m_sendFailures;
+        }
+    } while (m_next < m_numRecords && m_records[m_next].m_timeNs <= nowNs);
+    ScheduleNext();
+}
+
+/**
+ * Client with compound arrivals: each arrival event enqueues a whole batch of packets whose
+ * size is geometric or (1 + Poisson) distributed. Arrival events form a Poisson process that
+ * can be modulated by exponential ON/OFF periods. The event rate is derived so that the mean
+ * offered load stays at PacketsPerSlot packets per slot whatever the burst shape.
+ */
+class BurstyPacketSocketClient : public Application
+{
+  public:
+    static TypeId GetTypeId();
+
+    BurstyPacketSocketClient();
+    ~BurstyPacketSocketClient() override;
+
+    void SetRemote(PacketSocketAddress addr);
+
+    /**
+     * Assigns fixed random variable streams to the random variables of the client
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    void StartOnPeriod();
+    void ScheduleNextBurst();
+    void SendBurst();
+    uint32_t GetBurstSize();
+
+    uint32_t m_size;
+    uint8_t m_priority;
+    Time m_timeSlot;
+    double m_packetsPerSlot;
+    uint8_t m_burstSizeModel;
+    double m_meanBurstSize;
+    Time m_meanOnTime;
+    Time m_meanOffTime;
+
+    Ptr<ExponentialRandomVariable> m_interBurst;
+    Ptr<ExponentialRandomVariable> m_onOff;
+    Ptr<UniformRandomVariable> m_uniform;
+    Time m_onEnd; // end of the current ON period
+
+    Ptr<Socket> m_socket;
+    PacketSocketAddress m_peerAddress;
+    bool m_peerAddressSet{false};
+    EventId m_sendEvent;
+    uint64_t m_sent{0};
+
+    TracedCallback<Ptr<const Packet>, const Address&> m_txTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(BurstyPacketSocketClient);
+
+TypeId
+BurstyPacketSocketClient::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::BurstyPacketSocketClient")
+            .SetParent<Application>()
+            .AddConstructor<BurstyPacketSocketClient>()
+            .AddAttribute("PacketSize",
+                          "Size of packets generated (bytes)",
+                          UintegerValue(1000),
+                          MakeUintegerAccessor(&BurstyPacketSocketClient::m_size),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Priority",
+                          "Priority (TID) assigned to the packets",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&BurstyPacketSocketClient::m_priority),
+                          MakeUintegerChecker<uint8_t>(0, 7))
+            .AddAttribute("TimeSlot",
+                          "Time unit of PacketsPerSlot",
+                          TimeValue(MicroSeconds(9)),
+                          MakeTimeAccessor(&BurstyPacketSocketClient::m_timeSlot),
+                          MakeTimeChecker())
+            .AddAttribute("PacketsPerSlot",
+                          "Mean offered load (packets per slot)",
+                          DoubleValue(0.001),
+                          MakeDoubleAccessor(&BurstyPacketSocketClient::m_packetsPerSlot),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("BurstSizeModel",
+                          "Distribution of the packets per arrival event "
+                          "(0: geometric, 1: 1 + Poisson)",
+                          UintegerValue(BURST_GEOMETRIC),
+                          MakeUintegerAccessor(&BurstyPacketSocketClient::m_burstSizeModel),
+                          MakeUintegerChecker<uint8_t>(BURST_GEOMETRIC, BURST_POISSON))
+            .AddAttribute("MeanBurstSize",
+                          "Mean number of packets per arrival event",
+                          DoubleValue(1),
+                          MakeDoubleAccessor(&BurstyPacketSocketClient::m_meanBurstSize),
+                          MakeDoubleChecker<double>(1, MAX_MEAN_BURST_SIZE))
+            .AddAttribute("MeanOnTime",
+                          "Mean ON period (0 disables ON/OFF modulation)",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&BurstyPacketSocketClient::m_meanOnTime),
+                          MakeTimeChecker())
+            .AddAttribute("MeanOffTime",
+                          "Mean OFF period",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&BurstyPacketSocketClient::m_meanOffTime),
+                          MakeTimeChecker())
+            .AddTraceSource("Tx",
+                            "A packet has been sent",
+                            MakeTraceSourceAccessor(&BurstyPacketSocketClient::m_txTrace),
+                            "ns3::Packet::AddressTracedCallback");
+    return tid;
+}
+
+BurstyPacketSocketClient::BurstyPacketSocketClient()
+    : m_interBurst(CreateObject<ExponentialRandomVariable>()),
+      m_onOff(CreateObject<ExponentialRandomVariable>()),
+      m_uniform(CreateObject<UniformRandomVariable>())
+{
+}
+
+BurstyPacketSocketClient::~BurstyPacketSocketClient()
+{
+}
+
+void
+BurstyPacketSocketClient::SetRemote(PacketSocketAddress addr)
+{
+    m_peerAddress = addr;
+    m_peerAddressSet = true;
+}
+
+int64_t
+BurstyPacketSocketClient::AssignStreams(int64_t stream)
+{
+    m_interBurst->SetStream(stream);
+    m_onOff->SetStream(stream + 1);
+    m_uniform->SetStream(stream + 2);
+    return 3;
+}
+
+void
+BurstyPacketSocketClient::DoDispose()
+{
+    m_socket = nullptr;
+    Application::DoDispose();
+}
+
+void
+BurstyPacketSocketClient::StartApplication()
+{
+    NS_ASSERT_MSG(m_peerAddressSet, "Peer address not set");
+    if (!m_socket)
+    {
+        TypeId tid = TypeId::LookupByName("ns3::PacketSocketFactory");
+        m_socket = Socket::CreateSocket(GetNode(), tid);
+        m_socket->Bind(m_peerAddress);
+        m_socket->Connect(m_peerAddress);
+    }
+    m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    m_socket->SetPriority(m_priority);
+
+    if (m_packetsPerSlot <= 0)
+    {
+        return;
+    }
+    // burst events are only generated during ON periods, so they are denser by 1 / duty cycle
+    double dutyCycle = 1;
+    if (m_meanOnTime.IsStrictlyPositive())
+    {
+        dutyCycle = m_meanOnTime.GetSeconds() / (m_meanOnTime + m_meanOffTime).GetSeconds();
+    }
+    double burstsPerSlot = m_packetsPerSlot / m_meanBurstSize / dutyCycle;
+    m_interBurst->SetAttribute("Mean", DoubleValue(m_timeSlot.GetSeconds() / burstsPerSlot));
+
+    if (m_meanOnTime.IsStrictlyPositive())
+    {
+        StartOnPeriod();
+    }
+    else
+    {
+        m_onEnd = Time::Max();
+        ScheduleNextBurst();
+    }
+}
+
+void
+BurstyPacketSocketClient::StopApplication()
+{
+    Simulator::Cancel(m_sendEvent);
+    if (m_socket)
+    {
+        m_socket->Close();
+    }
+}
+
+void
+BurstyPacketSocketClient::StartOnPeriod()
+{
+    m_onOff->SetAttribute("Mean", DoubleValue(m_meanOnTime.GetSeconds()));
+    m_onEnd = Simulator::Now() + Seconds(m_onOff->GetValue());
+    ScheduleNextBurst();
+}
+
+void
+BurstyPacketSocketClient::ScheduleNextBurst()
+{
+    // inter-burst times are memoryless, so a draw falling past the ON period is simply dropped
+    Time next = Simulator::Now() + Seconds(m_interBurst->GetValue());
+    if (next < m_onEnd)
+    {
+        m_sendEvent = Simulator::Schedule(next - Simulator::Now(),
+                                          &BurstyPacketSocketClient::SendBurst,
+                                          this);
+        return;
+    }
+    m_onOff->SetAttribute("Mean", DoubleValue(m_meanOffTime.GetSeconds()));
+    Time onStart = m_onEnd + Seconds(m_onOff->GetValue());
+    m_sendEvent = Simulator::Schedule(onStart - Simulator::Now(),
+                                      &BurstyPacketSocketClient::StartOnPeriod,
+                                      this);
+}
+
+uint32_t
+BurstyPacketSocketClient::GetBurstSize()
+{
+    if (m_meanBurstSize <= 1)
+    {
+        return 1;
+    }
+    if (m_burstSizeModel == BURST_GEOMETRIC)
+    {
+        // inverse transform of a geometric variable on {1, 2, ...} with mean m_meanBurstSize
+        double u = 1 - m_uniform->GetValue(); // in (0, 1]
+        return 1 + static_cast<uint32_t>(std::floor(std::log(u) / std::log(1 - 1 / m_meanBurstSize)));
+    }
+    // Poisson part: unit rate exponential arrivals counted within the mean, i.e. Knuth's
+    // method in the log domain, where exp(-mean) cannot underflow
+    double lambda = m_meanBurstSize - 1;
+    double sum = -std::log(1 - m_uniform->GetValue());
+    uint32_t count = 0;
+    while (sum < lambda)
+    {
+        ++count;
+        sum -= std::log(1 - m_uniform->GetValue());
+    }
+    return 1 + count;
+}
+
+void
+BurstyPacketSocketClient::SendBurst()
+{
+    for (uint32_t n = GetBurstSize(); n > 0; --n)
+    {
+        Ptr<Packet> packet = Create<Packet>(m_size);
+        if (m_socket->Send(packet) >= 0)
+        {
+            m_txTrace(packet, m_peerAddress);
+            ++m_sent;
+        }
+    }
+    ScheduleNextBurst();
+}
+
+Ptr<PacketSocketClient>
+GetDeterministicClient(const PacketSocketAddress& sockAddr,
+                       const std::size_t pktSize,
+                       const Time& interval,
+                       const Time& start,
+                       const AcIndex linkAc)
+{
+    NS_ASSERT(linkAc != AC_UNDEF);
+    auto tid = wifiAcList.at(linkAc).GetLowTid(); // use the low TID
+
+    auto client = CreateObject<PacketSocketClient>();
+    client->SetAttribute("PacketSize", UintegerValue(pktSize));
+    client->SetAttribute("MaxPackets", UintegerValue(0));
+    client->SetAttribute("Interval", TimeValue(interval));
+    client->SetAttribute("Priority", UintegerValue(tid));
+    client->SetRemote(sockAddr);
+    client->SetStartTime(start);
+    return client;
+}
+
+Ptr<TraceReplayPacketSocketClient>
+GetTraceReplayClient(const PacketSocketAddress& sockAddr,
+                     const std::string& traceFile,
+                     const Time& start)
+{
+    // packet sizes and TIDs are taken from the trace
+    auto client = CreateObject<TraceReplayPacketSocketClient>();
+    client->SetAttribute("TraceFile", StringValue(traceFile));
+    client->SetRemote(sockAddr);
+    client->SetStartTime(start);
+    return client;
+}
+
+Ptr<BurstyPacketSocketClient>
+GetBurstyClient(const PacketSocketAddress& sockAddr,
+                const std::size_t pktSize,
+                const double packetsPerSlot,
+                const uint8_t burstSizeModel,
+                const BurstConfig& burst,
+                const Time& start,
+                const AcIndex linkAc)
+{
+    NS_ASSERT(linkAc != AC_UNDEF);
+    auto tid = wifiAcList.at(linkAc).GetLowTid();
+
+    auto client = CreateObject<BurstyPacketSocketClient>();
+    client->SetAttribute("PacketSize", UintegerValue(pktSize));
+    client->SetAttribute("TimeSlot", TimeValue(slotTime));
+    client->SetAttribute("PacketsPerSlot", DoubleValue(packetsPerSlot));
+    client->SetAttribute("BurstSizeModel", UintegerValue(burstSizeModel));
+    client->SetAttribute("MeanBurstSize", DoubleValue(burst.m_meanBurstSize));
+    // MilliSeconds() would truncate fractional periods
+    client->SetAttribute("MeanOnTime", TimeValue(Seconds(burst.m_meanOnMs / 1000)));
+    client->SetAttribute("MeanOffTime", TimeValue(Seconds(burst.m_meanOffMs / 1000)));
+    client->SetAttribute("Priority", UintegerValue(tid));
+    client->SetRemote(sockAddr);
+    client->SetStartTime(start);
+    return client;
+}
+
+/**
+ * Adds a spectrum channel for the given band (GHz) to the PHY helper and returns the
+ * ChannelSettings string of a link in that band, or an empty string if the band is unsupported.
+ */
+std::string
+AddBandChannel(SpectrumWifiPhyHelper& phyHelp,
+               const double frequency,
+               const int channelWidth,
+               const Ptr<PropagationLossModel>& lossModel)
+{
+    Ptr<MultiModelSpectrumChannel> phySpectrumChannel = CreateObject<
+        MultiModelSpectrumChannel>();
+    phySpectrumChannel->AddPropagationLossModel(lossModel);
+
+    std::string channelStr = "{0, " + std::to_string(channelWidth) + ", ";
+    if (frequency == 2.4)
+    {
+        channelStr += "BAND_2_4GHZ, 0}";
+        phyHelp.AddChannel(phySpectrumChannel, WIFI_SPECTRUM_2_4_GHZ);
+    }
+    else if (frequency == 5)
+    {
+        channelStr += "BAND_5GHZ, 0}";
+        phyHelp.AddChannel(phySpectrumChannel, WIFI_SPECTRUM_5_GHZ);
+    }
+    else if (frequency == 6)
+    {
+        channelStr += "BAND_6GHZ, 0}";
+        phyHelp.AddChannel(phySpectrumChannel, WIFI_SPECTRUM_6_GHZ);
+    }
+    else
+    {
+        return "";
+    }
+    return channelStr;
+}
+
+/**
+ * Parses a comma separated list holding one value per link. An empty string gives defaultValue
+ * on every link. Returns an empty vector if the number of values does not match nLinks.
+ */
+std::vector<double>
+ParseLinkValues(const std::string& values, const double defaultValue, const std::size_t nLinks)
+{
+    if (values.empty())
+    {
+        return std::vector<double>(nLinks, defaultValue);
+    }
+    std::vector<double> result;
+    std::stringstream valuesStream(values);
+    for (std::string item; std::getline(valuesStream, item, ',');)
+    {
+        result.push_back(std::stod(item));
+    }
+    if (result.size() != nLinks)
+    {
+        result.clear();
+    }
+    return result;
+}
+
+// Retries per delivered MPDU are binned up to MAX_RETRY_BINS - 1, the last bin is overflow
+constexpr std::size_t MAX_RETRY_BINS = 16;
+
+// Saturated EDCA backoff model of one AC (Bianchi-style Markov chain with an AIFS offset)
+struct BackoffModelAc
+{
+    double m_cwmin;      // W_0, CW of stage k is W_k = W_0 2^min(k, m)
+    uint32_t m_cwStage;  // m
+    double m_aifsOffset; // d, AIFSN minus the smallest AIFSN of the contending ACs
+    uint32_t m_nStas;    // contending stations
+    double m_p{0};   // collision probability
+    double m_tau{0}; // transmission probability per slot
+};
+
+/**
+ * Transmission probability of a saturated AC given its collision probability p: attempts per
+ * MPDU, 1 / (1 - p), over slots per MPDU, E[slots] = sum_k p^k ((W_k + 1) / 2 + d)
+ */
+double
+GetBackoffTau(const double p, const double cwmin, const uint32_t cwStage, const double aifsOffset)
+{
+    double slots = 0;
+    double pk = 1;
+    for (uint32_t k = 0; k < cwStage; ++k)
+    {
+        slots += pk * ((cwmin * std::pow(2, k) + 1) / 2 + aifsOffset);
+        pk *= p;
+    }
+    // stages beyond the cutoff keep the largest CW
+    slots += pk / (1 - p) * ((cwmin * std::pow(2, cwStage) + 1) / 2 + aifsOffset);
+    return 1 / (1 - p) / slots;
+}
+
+/**
+ * Solves the coupled collision probabilities of all ACs: an attempt of an AC collides unless
+ * every other contending station stays silent in that slot
+ */
+void
+SolveBackoffModel(std::map<AcIndex, BackoffModelAc>& model)
+{
+    for (uint32_t iteration = 0; iteration < 10000; ++iteration)
+    {
+        for (auto& entry : model)
+        {
+            auto& ac = entry.second;
+            ac.m_tau = GetBackoffTau(ac.m_p, ac.m_cwmin, ac.m_cwStage, ac.m_aifsOffset);
+        }
+        double maxChange = 0;
+        for (auto& entry : model)
+        {
+            double idle = 1;
+            for (const auto& other : model)
+            {
+                uint32_t n = other.second.m_nStas - (other.first == entry.first ? 1 : 0);
+                idle *= std::pow(1 - other.second.m_tau, n);
+            }
+            double p = std::min(1 - idle, 0.999999);
+            maxChange = std::max(maxChange, std::abs(p - entry.second.m_p));
+            entry.second.m_p = 0.5 * entry.second.m_p + 0.5 * p; // damped
+        }
+        if (maxChange < 1e-10)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * Probability that a delivered MPDU reached backoff stage k = 0..m, i.e. min(retries, m) = k,
+ * when every attempt collides with probability p
+ */
+std::vector<double>
+GetStageProbabilities(const double p, const uint32_t cwStage)
+{
+    std::vector<double> probs(cwStage + 1);
+    for (uint32_t k = 0; k < cwStage; ++k)
+    {
+        probs[k] = (1 - p) * std::pow(p, k);
+    }
+    probs[cwStage] = std::pow(p, cwStage);
+    return probs;
+}
+
+// MAC event tracing (--macTraceFile), the file is written by a background thread
+std::unique_ptr<MacTraceWriter> g_macTraceWriter;
+std::array<double, 4> g_macTraceSampling{1, 1, 1, 1}; // fraction of events kept per AC
+std::vector<std::pair<Time, Time>> g_macTraceWindows;  // traced time windows, empty for all
+uint64_t g_macTraceRng{0x9e3779b97f4a7c15}; // not an ns-3 stream, so tracing keeps results as is
+
+bool
+SampleMacEvent(const AcIndex ac, const Time& time)
+{
+    if (!g_macTraceWindows.empty() &&
+        std::none_of(g_macTraceWindows.begin(),
+                     g_macTraceWindows.end(),
+                     [&time](const auto& window) {
+                         return time >= window.first && time < window.second;
+                     }))
+    {
+        return false;
+    }
+    if (ac >= g_macTraceSampling.size() || g_macTraceSampling[ac] >= 1)
+    {
+        return true;
+    }
+    // xorshift64
+    g_macTraceRng ^= g_macTraceRng << 13;
+    g_macTraceRng ^= g_macTraceRng >> 7;
+    g_macTraceRng ^= g_macTraceRng << 17;
+    return (g_macTraceRng >> 11) * 0x1.0p-53 < g_macTraceSampling[ac];
+}
+
+void
+PushMacEvent(const uint32_t nodeId,
+             const MacTraceEvent event,
+             const AcIndex ac,
+             const uint8_t linkId,
+             const uint32_t arg,
+             const Time& time)
+{
+    g_macTraceWriter->Record({static_cast<uint64_t>(time.GetNanoSeconds()),
+                              nodeId,
+                              arg,
+                              event,
+                              static_cast<uint8_t>(ac),
+                              linkId,
+                              0});
+}
+
+AcIndex
+GetMpduAc(Ptr<const WifiMpdu> mpdu)
+{
+    return mpdu->GetHeader().IsQosData() ? QosUtilsMapTidToAc(mpdu->GetHeader().GetQosTid())
+                                         : AC_UNDEF;
+}
+
+// Size of the application payload carried by an MPDU (its MSDU without the LLC/SNAP header)
+uint32_t
+GetMpduPayloadSize(Ptr<const WifiMpdu> mpdu)
+{
+    uint32_t size = mpdu->GetPacket()->GetSize();
+    uint32_t llcSize = LlcSnapHeader().GetSerializedSize();
+    return size > llcSize ? size - llcSize : 0;
+}
+
+void
+MacTraceBackoff(uint32_t nodeId, Ptr<WifiMac> mac, AcIndex ac, uint32_t backoff, uint8_t linkId)
+{
+    const Time now = Simulator::Now();
+    if (!SampleMacEvent(ac, now))
+    {
+        return;
+    }
+    PushMacEvent(nodeId, MAC_TRACE_BACKOFF_DRAWN, ac, linkId, backoff, now);
+    // backoff slots are only counted down once the medium has been idle for AIFS; the end of
+    // AIFS is only projected here, so it is logged at the draw time with the offset as argument
+    Time aifsEnd =
+        mac->GetChannelAccessManager(linkId)->GetBackoffStartFor(mac->GetQosTxop(ac));
+    int64_t aifsOffsetNs = std::clamp<int64_t>((aifsEnd - now).GetNanoSeconds(),
+                                               0,
+                                               std::numeric_limits<uint32_t>::max());
+    PushMacEvent(nodeId,
+                 MAC_TRACE_AIFS_PROJECTED,
+                 ac,
+                 linkId,
+                 static_cast<uint32_t>(aifsOffsetNs),
+                 now);
+}
+
+void
+MacTraceTxStart(uint32_t nodeId,
+                uint8_t linkId,
+                WifiConstPsduMap psduMap,
+                WifiTxVector txVector,
+                double txPowerW)
+{
+    const Time now = Simulator::Now();
+    for (const auto& staIdPsdu : psduMap)
+    {
+        Ptr<const WifiMpdu> mpdu = *staIdPsdu.second->begin();
+        AcIndex ac = GetMpduAc(mpdu);
+        if (ac != AC_UNDEF && SampleMacEvent(ac, now))
+        {
+            PushMacEvent(nodeId,
+                         MAC_TRACE_TX_START,
+                         ac,
+                         linkId,
+                         mpdu->GetHeader().GetSequenceNumber(),
+                         now);
+        }
+    }
+}
+
+void
+MacTraceMpdu(uint32_t nodeId, MacTraceEvent event, Ptr<const WifiMpdu> mpdu)
+{
+    const Time now = Simulator::Now();
+    AcIndex ac = GetMpduAc(mpdu);
+    if (ac != AC_UNDEF && SampleMacEvent(ac, now))
+    {
+        PushMacEvent(nodeId,
+                     event,
+                     ac,
+                     MAC_TRACE_NO_LINK,
+                     mpdu->GetHeader().GetSequenceNumber(),
+                     now);
+    }
+}
+
+/**
+ * Connects the MAC event tracer to the EDCA functions, MAC and PHYs of the given nodes
+ */
+void
+EnableMacTrace(const NodeContainer& nodes)
+{
+    for (auto nodeIt = nodes.Begin(); nodeIt != nodes.End(); ++nodeIt)
+    {
+        uint32_t nodeId = (*nodeIt)->GetId();
+        auto device = DynamicCast<WifiNetDevice>((*nodeIt)->GetDevice(0));
+        auto mac = device->GetMac();
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            auto txop = mac->GetQosTxop(ac);
+            txop->TraceConnectWithoutContext("BackoffTrace",
+                                             MakeBoundCallback(&MacTraceBackoff, nodeId, mac, ac));
+            txop->GetWifiMacQueue()->TraceConnectWithoutContext(
+                "Dequeue",
+                MakeBoundCallback(&MacTraceMpdu, nodeId, MAC_TRACE_DEQUEUE));
+        }
+        mac->TraceConnectWithoutContext("AckedMpdu",
+                                        MakeBoundCallback(&MacTraceMpdu, nodeId, MAC_TRACE_ACK));
+        mac->TraceConnectWithoutContext(
+            "NAckedMpdu",
+            MakeBoundCallback(&MacTraceMpdu, nodeId, MAC_TRACE_COLLISION));
+        for (uint8_t linkId = 0; linkId < device->GetNPhys(); ++linkId)
+        {
+            device->GetPhy(linkId)->TraceConnectWithoutContext(
+                "PhyTxPsduBegin",
+                MakeBoundCallback(&MacTraceTxStart, nodeId, linkId));
+        }
+    }
+}
+
+// Backlog of one AC summed over the queues of all the probed nodes
+struct QueueBacklog
+{
+    uint64_t m_packets{0};
+    uint64_t m_bytes{0};
+    double m_holAgeMs{0};        // age of the oldest head-of-line MPDU
+    uint64_t m_maxStaPackets{0}; // largest backlog of a single STA (the AP excluded)
+};
+
+// Per AC backlog statistics over the periodic queue probes
+struct QueueProbeStats
+{
+    uint64_t m_samples{0};
+    double m_sumPackets{0};
+    double m_sumBytes{0};
+    uint64_t m_maxPackets{0};
+    uint64_t m_maxBytes{0};
+    double m_maxHolAgeMs{0};
+    uint64_t m_maxStaPackets{0};
+    // least squares fit of the backlog (packets) against the probe time (s)
+    double m_sumT{0};
+    double m_sumT2{0};
+    double m_sumTPackets{0};
+
+    /// Slope of the fitted backlog (packets/s), 0 with fewer than two probes
+    double GetGrowthRate() const
+    {
+        double den = m_samples * m_sumT2 - m_sumT * m_sumT;
+        return den > 0 ? (m_samples * m_sumTPackets - m_sumT * m_sumPackets) / den : 0;
+    }
+};
+
+std::map<AcIndex, QueueBacklog>
+GetQueueBacklog(const NodeContainer& nodes, uint32_t apNodeId)
+{
+    std::map<AcIndex, QueueBacklog> backlogMap;
+    for (auto nodeIt = nodes.Begin(); nodeIt != nodes.End(); ++nodeIt)
+    {
+        auto mac = DynamicCast<WifiNetDevice>((*nodeIt)->GetDevice(0))->GetMac();
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            auto queue = mac->GetQosTxop(ac)->GetWifiMacQueue();
+            auto& backlog = backlogMap[ac];
+            backlog.m_packets += queue->GetNPackets();
+            backlog.m_bytes += queue->GetNBytes();
+            if ((*nodeIt)->GetId() != apNodeId)
+            {
+                backlog.m_maxStaPackets =
+                    std::max<uint64_t>(backlog.m_maxStaPackets, queue->GetNPackets());
+            }
+            if (auto head = queue->Peek())
+            {
+                double holAgeMs = (Simulator::Now() - head->GetTimestamp()).GetSeconds() * 1000;
+                backlog.m_holAgeMs = std::max(backlog.m_holAgeMs, holAgeMs);
+            }
+        }
+    }
+    return backlogMap;
+}
+
+void
+ProbeQueues(const NodeContainer& nodes,
+            uint32_t apNodeId,
+            Time interval,
+            Time stop,
+            std::map<AcIndex, QueueProbeStats>* statsMap)
+{
+    const double t = Simulator::Now().GetSeconds();
+    for (const auto& entry : GetQueueBacklog(nodes, apNodeId))
+    {
+        auto& stats = (*statsMap)[entry.first];
+        ++stats.m_samples;
+        stats.m_sumPackets += entry.second.m_packets;
+        stats.m_sumBytes += entry.second.m_bytes;
+        stats.m_maxPackets = std::max(stats.m_maxPackets, entry.second.m_packets);
+        stats.m_maxBytes = std::max(stats.m_maxBytes, entry.second.m_bytes);
+        stats.m_maxHolAgeMs = std::max(stats.m_maxHolAgeMs, entry.second.m_holAgeMs);
+        stats.m_maxStaPackets = std::max(stats.m_maxStaPackets, entry.second.m_maxStaPackets);
+        stats.m_sumT += t;
+        stats.m_sumT2 += t * t;
+        stats.m_sumTPackets += t * entry.second.m_packets;
+    }
+    if (Simulator::Now() + interval < stop)
+    {
+        Simulator::Schedule(interval, &ProbeQueues, nodes, apNodeId, interval, stop, statsMap);
+    }
+}
+
+// Live progress (--statusFile), periodically rewritten so that sweeps can be watched
+struct ProgressStatus
+{
+    std::string m_file;
+    std::string m_config; // JSON object identifying the run
+    Time m_statsStart;
+    Time m_stop;
+    std::chrono::steady_clock::time_point m_wallStart;
+    double m_lastWriteWallS{-1};
+    std::array<uint64_t, 4> m_acked{};
+    std::array<uint64_t, 4> m_ackedBytes{};
+    std::array<long double, 4> m_delaySumMs{}; // timestamp -> ack, i.e. end-to-end delay
+};
+
+void
+ProgressAckedMpdu(ProgressStatus* status, Ptr<const WifiMpdu> mpdu)
+{
+    const Time now = Simulator::Now();
+    AcIndex ac = GetMpduAc(mpdu);
+    if (ac == AC_UNDEF || now < status->m_statsStart)
+    {
+        return;
+    }
+    ++status->m_acked[ac];
+    status->m_ackedBytes[ac] += GetMpduPayloadSize(mpdu);
+    status->m_delaySumMs[ac] += (now - mpdu->GetTimestamp()).GetSeconds() * 1000;
+}
+
+void
+WriteProgressStatus(ProgressStatus* status, bool done)
+{
+    double wallS =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - status->m_wallStart)
+            .count();
+    double simS = Simulator::Now().GetSeconds();
+    double simPerWall = wallS > 0 ? simS / wallS : 0;
+    double etaS = simPerWall > 0 ? (status->m_stop.GetSeconds() - simS) / simPerWall : -1;
+    double statsS = (Simulator::Now() - status->m_statsStart).GetSeconds();
+    uint64_t events = Simulator::GetEventCount();
+
+    // write then rename, so that readers never see a partial file
+    std::string tmpFile = status->m_file + ".tmp";
+    {
+        std::ofstream out(tmpFile);
+        out << "{\"pid\": " << getpid() << ", \"done\": " << (done ? "true" : "false")
+            << ", \"config\": " << status->m_config << ", \"sim_s\": " << simS
+            << ", \"sim_end_s\": " << status->m_stop.GetSeconds() << ", \"wall_s\": " << wallS
+            << ", \"sim_per_wall\": " << simPerWall << ", \"eta_s\": " << (done ? 0 : etaS)
+            << ", \"events\": " << events
+            << ", \"events_per_s\": " << (wallS > 0 ? events / wallS : 0) << ", \"ac\": {";
+        const char* acNames[] = {"BE", "BK", "VI", "VO"};
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            double thpt = statsS > 0 ? status->m_ackedBytes[ac] * 8.0 / statsS / 1000000 : 0;
+            double delay =
+                status->m_acked[ac] > 0 ? status->m_delaySumMs[ac] / status->m_acked[ac] : 0;
+            out << (ac == AC_BE ? "" : ", ") << "\"" << acNames[ac] << "\": {\"acked\": "
+                << status->m_acked[ac] << ", \"thpt_mbps\": " << thpt
+                << ", \"mean_delay_ms\": " << delay << "}";
+        }
+        out << "}}\n";
+    }
+    std::rename(tmpFile.c_str(), status->m_file.c_str());
+    status->m_lastWriteWallS = wallS;
+}
+
+void
+UpdateProgressStatus(ProgressStatus* status, Time interval, double wallIntervalS)
+{
+    // simulated intervals may pass much faster than wall time, so writes are also throttled
+    double wallS =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - status->m_wallStart)
+            .count();
+    if (wallS - status->m_lastWriteWallS >= wallIntervalS)
+    {
+        WriteProgressStatus(status, false);
+    }
+    if (Simulator::Now() + interval < status->m_stop)
+    {
+        Simulator::Schedule(interval, &UpdateProgressStatus, status, interval, wallIntervalS);
+    }
+}
+
+/**
+ * Connects the progress counters to the MAC of the given nodes
+ */
+void
+EnableProgressStatus(const NodeContainer& nodes, ProgressStatus* status)
+{
+    for (auto nodeIt = nodes.Begin(); nodeIt != nodes.End(); ++nodeIt)
+    {
+        auto mac = DynamicCast<WifiNetDevice>((*nodeIt)->GetDevice(0))->GetMac();
+        mac->TraceConnectWithoutContext("AckedMpdu", MakeBoundCallback(&ProgressAckedMpdu, status));
+    }
+}
+
+// Per-packet records (--packetRecordFile), streamed to the file in delta-encoded blocks
+struct PacketRecordExport
+{
+    // MPDU not acknowledged yet
+    struct InFlight
+    {
+        uint32_t m_failures{0};
+        uint8_t m_linkId{0}; // link of the last transmission
+    };
+
+    std::unique_ptr<PacketRecordWriter> m_writer;
+    Time m_statsStart;
+    Time m_statsStop;
+    std::map<Mac48Address, uint32_t> m_nodeIds; // MLD and link addresses to node ID
+    std::vector<std::unordered_map<uint64_t, InFlight>> m_inFlight; // per node, by packet UID
+};
+
+void
+PacketRecordTxStart(PacketRecordExport* records,
+                    uint32_t nodeId,
+                    uint8_t linkId,
+                    WifiConstPsduMap psduMap,
+                    WifiTxVector txVector,
+                    double txPowerW)
+{
+    for (const auto& staIdPsdu : psduMap)
+    {
+        for (const auto& mpdu : *staIdPsdu.second)
+        {
+            if (GetMpduAc(mpdu) != AC_UNDEF)
+            {
+                records->m_inFlight[nodeId][mpdu->GetPacket()->GetUid()].m_linkId = linkId;
+            }
+        }
+    }
+}
+
+void
+PacketRecordNAcked(PacketRecordExport* records, uint32_t nodeId, Ptr<const WifiMpdu> mpdu)
+{
+    ++records->m_inFlight[nodeId][mpdu->GetPacket()->GetUid()].m_failures;
+}
+
+void
+PacketRecordDropped(PacketRecordExport* records,
+                    uint32_t nodeId,
+                    WifiMacDropReason reason,
+                    Ptr<const WifiMpdu> mpdu)
+{
+    records->m_inFlight[nodeId].erase(mpdu->GetPacket()->GetUid());
+}
+
+void
+PacketRecordAcked(PacketRecordExport* records, uint32_t nodeId, Ptr<const WifiMpdu> mpdu)
+{
+    const Time now = Simulator::Now();
+    PacketRecordExport::InFlight inFlight;
+    auto& nodeInFlight = records->m_inFlight[nodeId];
+    auto it = nodeInFlight.find(mpdu->GetPacket()->GetUid());
+    if (it != nodeInFlight.end())
+    {
+        inFlight = it->second;
+        nodeInFlight.erase(it);
+    }
+    AcIndex ac = GetMpduAc(mpdu);
+    if (ac == AC_UNDEF || now < records->m_statsStart || now >= records->m_statsStop)
+    {
+        return;
+    }
+    auto dstIt = records->m_nodeIds.find(mpdu->GetHeader().GetAddr1());
+    records->m_writer->Add(nodeId,
+                           ac,
+                           {static_cast<uint64_t>(mpdu->GetTimestamp().GetNanoSeconds()),
+                            static_cast<uint64_t>(now.GetNanoSeconds()),
+                            inFlight.m_failures,
+                            dstIt != records->m_nodeIds.end() ? dstIt->second : UINT32_MAX,
+                            inFlight.m_linkId});
+}
+
+/**
+ * Connects the per-packet record export to the MAC and PHYs of the given nodes
+ */
+void
+EnablePacketRecords(const NodeContainer& nodes, PacketRecordExport* records)
+{
+    for (auto nodeIt = nodes.Begin(); nodeIt != nodes.End(); ++nodeIt)
+    {
+        uint32_t nodeId = (*nodeIt)->GetId();
+        auto device = DynamicCast<WifiNetDevice>((*nodeIt)->GetDevice(0));
+        auto mac = device->GetMac();
+        records->m_nodeIds[mac->GetAddress()] = nodeId;
+        for (uint8_t linkId = 0; linkId < mac->GetNLinks(); ++linkId)
+        {
+            records->m_nodeIds[mac->GetFrameExchangeManager(linkId)->GetAddress()] = nodeId;
+        }
+        if (nodeId >= records->m_inFlight.size())
+        {
+            records->m_inFlight.resize(nodeId + 1);
+        }
+        mac->TraceConnectWithoutContext("AckedMpdu",
+                                        MakeBoundCallback(&PacketRecordAcked, records, nodeId));
+        mac->TraceConnectWithoutContext("NAckedMpdu",
+                                        MakeBoundCallback(&PacketRecordNAcked, records, nodeId));
+        mac->TraceConnectWithoutContext("DroppedMpdu",
+                                        MakeBoundCallback(&PacketRecordDropped, records, nodeId));
+        for (uint8_t linkId = 0; linkId < device->GetNPhys(); ++linkId)
+        {
+            device->GetPhy(linkId)->TraceConnectWithoutContext(
+                "PhyTxPsduBegin",
+                MakeBoundCallback(&PacketRecordTxStart, records, nodeId, linkId));
+        }
+    }
+}
 
-Ptr<PacketSocketClient>
-GetDeterministicClient(const PacketSocketAddress& sockAddr,
-                       const std::size_t pktSize,
-                       const Time& interval,
-                       const Time& start,
-                       const AcIndex linkAc)
+// Acknowledged payload bytes per node, AC and destination. The WifiTxStatsHelper records carry
+// no size, so their success counts are converted to bytes with the mean size measured here,
+// which is payloadSize unless STAs replay traces.
+struct AckedBytes
 {
-    NS_ASSERT(linkAc != AC_UNDEF);
-    auto tid = wifiAcList.at(linkAc).GetLowTid(); // use the low TID
+    Time m_statsStart;
+    Time m_statsStop;
+    std::map<Mac48Address, uint32_t> m_nodeIds; // MLD and link addresses to node ID
+    // node ID -> AC -> destination node ID -> (MPDUs, bytes)
+    std::map<uint32_t, std::map<AcIndex, std::map<uint32_t, std::pair<uint64_t, uint64_t>>>>
+        m_acked;
+};
 
-    auto client = CreateObject<PacketSocketClient>();
-    client->SetAttribute("PacketSize", UintegerValue(pktSize));
-    client->SetAttribute("MaxPackets", UintegerValue(0));
-    client->SetAttribute("Interval", TimeValue(interval));
-    client->SetAttribute("Priority", UintegerValue(tid));
-    client->SetRemote(sockAddr);
-    client->SetStartTime(start);
-    return client;
+void
+AckedBytesMpdu(AckedBytes* acked, uint32_t nodeId, Ptr<const WifiMpdu> mpdu)
+{
+    const Time now = Simulator::Now();
+    AcIndex ac = GetMpduAc(mpdu);
+    if (ac == AC_UNDEF || now < acked->m_statsStart || now >= acked->m_statsStop)
+    {
+        return;
+    }
+    auto dstIt = acked->m_nodeIds.find(mpdu->GetHeader().GetAddr1());
+    auto& entry = acked->m_acked[nodeId][ac][dstIt != acked->m_nodeIds.end() ? dstIt->second
+                                                                             : UINT32_MAX];
+    ++entry.first;
+    entry.second += GetMpduPayloadSize(mpdu);
 }
 
-Ptr<BernoulliPacketSocketClient>
-GetBernoulliClient(const PacketSocketAddress& sockAddr,
-                   const std::size_t pktSize,
-                   const double prob,
-                   const Time& start,
-                   const AcIndex linkAc)
+/**
+ * Connects the acknowledged bytes counters to the MAC of the given nodes
+ */
+void
+EnableAckedBytes(const NodeContainer& nodes, AckedBytes* acked)
 {
-    NS_ASSERT(linkAc != AC_UNDEF);
-    auto tid = wifiAcList.at(linkAc).GetLowTid();
+    for (auto nodeIt = nodes.Begin(); nodeIt != nodes.End(); ++nodeIt)
+    {
+        uint32_t nodeId = (*nodeIt)->GetId();
+        auto mac = DynamicCast<WifiNetDevice>((*nodeIt)->GetDevice(0))->GetMac();
+        acked->m_nodeIds[mac->GetAddress()] = nodeId;
+        for (uint8_t linkId = 0; linkId < mac->GetNLinks(); ++linkId)
+        {
+            acked->m_nodeIds[mac->GetFrameExchangeManager(linkId)->GetAddress()] = nodeId;
+        }
+        mac->TraceConnectWithoutContext("AckedMpdu",
+                                        MakeBoundCallback(&AckedBytesMpdu, acked, nodeId));
+    }
+}
 
-    auto client = CreateObject<BernoulliPacketSocketClient>();
-    client->SetAttribute("PacketSize", UintegerValue(pktSize));
-    client->SetAttribute("MaxPackets", UintegerValue(0));
-    client->SetAttribute("TimeSlot", TimeValue(slotTime));
-    client->SetAttribute("BernoulliPr", DoubleValue(prob));
-    client->SetAttribute("Priority", UintegerValue(tid));
-    client->SetRemote(sockAddr);
-    client->SetStartTime(start);
-    return client;
+/**
+ * Mean acknowledged payload size of an AC over the nodes accepted by the filter, and towards
+ * dst only if given; defaultSize if nothing of the kind was acknowledged
+ */
+template <typename NodeFilter>
+double
+GetMeanAckedSize(const AckedBytes& acked,
+                 AcIndex ac,
+                 NodeFilter nodeFilter,
+                 uint32_t defaultSize,
+                 std::optional<uint32_t> dst = std::nullopt)
+{
+    uint64_t mpdus = 0;
+    uint64_t bytes = 0;
+    for (const auto& nodeMap : acked.m_acked)
+    {
+        auto acIt = nodeMap.second.find(ac);
+        if (!nodeFilter(nodeMap.first) || acIt == nodeMap.second.end())
+        {
+            continue;
+        }
+        for (const auto& dstEntry : acIt->second)
+        {
+            if (!dst || *dst == dstEntry.first)
+            {
+                mpdus += dstEntry.second.first;
+                bytes += dstEntry.second.second;
+            }
+        }
+    }
+    return mpdus > 0 ? static_cast<double>(bytes) / mpdus : defaultSize;
 }
 
 int
@@ -138,6 +1369,7 @@ main(int argc, char* argv[])
     double frequency{5};
     int mcs{6};
     int channelWidth = 20;
+    std::string linkFrequencies{""}; // one band per link of an MLD, e.g. "5,6"
 
     // SLD STAs parameters
     std::size_t nSld{5};
@@ -152,6 +1384,53 @@ main(int argc, char* argv[])
     uint8_t sldAcInt_VI{AC_VI};
     uint8_t sldAcInt_VO{AC_VO};
     int trafficType = 1;
+    std::string traceFilePrefix{"sld-trace-"};
+    std::string traceStas{""};
+
+    // binary MAC event trace
+    std::string macTraceFile{""};
+    double macTraceSampleBE{1};
+    double macTraceSampleBK{1};
+    double macTraceSampleVI{1};
+    double macTraceSampleVO{1};
+    std::string macTraceWindows{""};
+    uint32_t macTraceRingSize{4096};
+
+    // queue backlog probes
+    double queueProbeIntervalMs{10};
+    uint32_t queueUnstablePkts{10};
+
+    std::string perfStatsFile{""}; // wall and simulated time, events and peak RSS (JSON)
+
+    // live progress
+    std::string statusFile{""};
+    double statusIntervalMs{100};
+    double statusWallIntervalS{1};
+
+    // per-packet record export
+    std::string packetRecordFile{""};
+    uint32_t packetRecordBlock{4096};
+
+    // compound arrivals (trafficType 3): packets per arrival event and ON/OFF periods per AC
+    int burstSizeModel = BURST_GEOMETRIC;
+    double acBEMeanBurst{1};
+    double acBEOnMs{0};
+    double acBEOffMs{0};
+    double acBKMeanBurst{1};
+    double acBKOnMs{0};
+    double acBKOffMs{0};
+    double acVIMeanBurst{1};
+    double acVIOnMs{0};
+    double acVIOffMs{0};
+    double acVOMeanBurst{1};
+    double acVOOnMs{0};
+    double acVOOffMs{0};
+
+    // traffic direction per AC (0: uplink, 1: downlink, 2: both)
+    int acBEDir{0};
+    int acBKDir{0};
+    int acVIDir{0};
+    int acVODir{0};
 
     // EDCA configuration for CWmins, CWmaxs
     /**
@@ -166,12 +1445,27 @@ main(int argc, char* argv[])
     uint64_t acVOCwmin{4};
     uint8_t acVOCwStage{2};
 
+    // per link overrides of the above for MLDs, e.g. "16,32" (empty: same on all links)
+    std::string acBECwminLinks{""};
+    std::string acBECwStageLinks{""};
+    std::string acBKCwminLinks{""};
+    std::string acBKCwStageLinks{""};
+    std::string acVICwminLinks{""};
+    std::string acVICwStageLinks{""};
+    std::string acVOCwminLinks{""};
+    std::string acVOCwStageLinks{""};
+
     CommandLine cmd(__FILE__);
     cmd.AddValue("rngRun", "Seed for simulation", rngRun);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
     cmd.AddValue("payloadSize", "Application payload size in Bytes", payloadSize);
     cmd.AddValue("mcs", "MCS", mcs);
     cmd.AddValue("channelWidth", "Bandwidth", channelWidth);
+    cmd.AddValue("frequency", "Band of the link (2.4, 5 or 6 GHz)", frequency);
+    cmd.AddValue("linkFrequencies",
+                 "Comma separated band of each link for an MLD setup (e.g. 5,6), "
+                 "overrides frequency",
+                 linkFrequencies);
     cmd.AddValue("nSld", "Number of SLD STAs on link 1", nSld);
     cmd.AddValue("perSldLambda",
                  "Per node Bernoulli arrival rate of SLD STAs",
@@ -189,7 +1483,77 @@ main(int argc, char* argv[])
     cmd.AddValue("acVICwStage", "Cutoff Stage for AC_VI", acVICwStage);
     cmd.AddValue("acVOCwmin", "Initial CW for AC_VO", acVOCwmin);
     cmd.AddValue("acVOCwStage", "Cutoff Stage for AC_VO", acVOCwStage);
+    cmd.AddValue("acBECwminLinks", "Per link initial CW for AC_BE (MLD)", acBECwminLinks);
+    cmd.AddValue("acBECwStageLinks", "Per link cutoff stage for AC_BE (MLD)", acBECwStageLinks);
+    cmd.AddValue("acBKCwminLinks", "Per link initial CW for AC_BK (MLD)", acBKCwminLinks);
+    cmd.AddValue("acBKCwStageLinks", "Per link cutoff stage for AC_BK (MLD)", acBKCwStageLinks);
+    cmd.AddValue("acVICwminLinks", "Per link initial CW for AC_VI (MLD)", acVICwminLinks);
+    cmd.AddValue("acVICwStageLinks", "Per link cutoff stage for AC_VI (MLD)", acVICwStageLinks);
+    cmd.AddValue("acVOCwminLinks", "Per link initial CW for AC_VO (MLD)", acVOCwminLinks);
+    cmd.AddValue("acVOCwStageLinks", "Per link cutoff stage for AC_VO (MLD)", acVOCwStageLinks);
     cmd.AddValue("trafficType", "traffic type", trafficType);
+    cmd.AddValue("traceFilePrefix",
+                 "Trace of STA i (0-based) is read from <prefix><i>.bin (trace replay traffic)",
+                 traceFilePrefix);
+    cmd.AddValue("traceStas",
+                 "Comma separated STA indices replaying a trace regardless of trafficType",
+                 traceStas);
+    cmd.AddValue("macTraceFile",
+                 "Binary MAC event trace (decode with mac-trace-decode), empty to disable",
+                 macTraceFile);
+    cmd.AddValue("macTraceSampleBE", "Fraction of AC_BE MAC events traced", macTraceSampleBE);
+    cmd.AddValue("macTraceSampleBK", "Fraction of AC_BK MAC events traced", macTraceSampleBK);
+    cmd.AddValue("macTraceSampleVI", "Fraction of AC_VI MAC events traced", macTraceSampleVI);
+    cmd.AddValue("macTraceSampleVO", "Fraction of AC_VO MAC events traced", macTraceSampleVO);
+    cmd.AddValue("macTraceWindows",
+                 "Comma separated start-stop windows (s) of MAC tracing, e.g. 6-6.5,12-12.1",
+                 macTraceWindows);
+    cmd.AddValue("macTraceRingSize", "MAC trace records buffered per node", macTraceRingSize);
+    cmd.AddValue("queueProbeIntervalMs",
+                 "Interval of the per AC queue backlog probes (ms), 0 to disable",
+                 queueProbeIntervalMs);
+    cmd.AddValue("queueUnstablePkts",
+                 "Backlog growth (packets) over the stats window above which an AC queue is "
+                 "flagged unstable",
+                 queueUnstablePkts);
+    cmd.AddValue("perfStatsFile",
+                 "File receiving wall and simulated time, events and peak RSS of the run as "
+                 "JSON",
+                 perfStatsFile);
+    cmd.AddValue("statusFile",
+                 "JSON file periodically rewritten with the progress of the run",
+                 statusFile);
+    cmd.AddValue("statusIntervalMs",
+                 "Simulated time between progress updates (ms)",
+                 statusIntervalMs);
+    cmd.AddValue("statusWallIntervalS",
+                 "Minimum wall time between two writes of the status file (s)",
+                 statusWallIntervalS);
+    cmd.AddValue("packetRecordFile",
+                 "Binary file receiving enqueue/dequeue time, failures and link of every acked MPDU",
+                 packetRecordFile);
+    cmd.AddValue("packetRecordBlock",
+                 "Records buffered per node and AC before a block is written",
+                 packetRecordBlock);
+    cmd.AddValue("burstSizeModel",
+                 "Packets per arrival event for trafficType 3 (0: geometric, 1: 1 + Poisson)",
+                 burstSizeModel);
+    cmd.AddValue("acBEMeanBurst", "Mean packets per arrival event for AC_BE", acBEMeanBurst);
+    cmd.AddValue("acBEOnMs", "Mean ON period (ms) for AC_BE, 0 for always on", acBEOnMs);
+    cmd.AddValue("acBEOffMs", "Mean OFF period (ms) for AC_BE", acBEOffMs);
+    cmd.AddValue("acBKMeanBurst", "Mean packets per arrival event for AC_BK", acBKMeanBurst);
+    cmd.AddValue("acBKOnMs", "Mean ON period (ms) for AC_BK, 0 for always on", acBKOnMs);
+    cmd.AddValue("acBKOffMs", "Mean OFF period (ms) for AC_BK", acBKOffMs);
+    cmd.AddValue("acVIMeanBurst", "Mean packets per arrival event for AC_VI", acVIMeanBurst);
+    cmd.AddValue("acVIOnMs", "Mean ON period (ms) for AC_VI, 0 for always on", acVIOnMs);
+    cmd.AddValue("acVIOffMs", "Mean OFF period (ms) for AC_VI", acVIOffMs);
+    cmd.AddValue("acVOMeanBurst", "Mean packets per arrival event for AC_VO", acVOMeanBurst);
+    cmd.AddValue("acVOOnMs", "Mean ON period (ms) for AC_VO, 0 for always on", acVOOnMs);
+    cmd.AddValue("acVOOffMs", "Mean OFF period (ms) for AC_VO", acVOOffMs);
+    cmd.AddValue("acBEDir", "Direction of AC_BE traffic (0: UL, 1: DL, 2: UL+DL)", acBEDir);
+    cmd.AddValue("acBKDir", "Direction of AC_BK traffic (0: UL, 1: DL, 2: UL+DL)", acBKDir);
+    cmd.AddValue("acVIDir", "Direction of AC_VI traffic (0: UL, 1: DL, 2: UL+DL)", acVIDir);
+    cmd.AddValue("acVODir", "Direction of AC_VO traffic (0: UL, 1: DL, 2: UL+DL)", acVODir);
     cmd.Parse(argc, argv);
 
     RngSeedManager::SetSeed(rngRun);
@@ -200,19 +1564,52 @@ main(int argc, char* argv[])
     auto BKAc = static_cast<AcIndex>(sldAcInt_BK);
     auto VIAc = static_cast<AcIndex>(sldAcInt_VI);
     auto VOAc = static_cast<AcIndex>(sldAcInt_VO);
-    
 
-    uint64_t acBECwmax = acBECwmin * pow(2, acBECwStage);
-    acBECwmax -= 1;
+    // links of the AP and STAs (a single link unless linkFrequencies is given)
+    std::size_t nLinks = linkFrequencies.empty()
+                             ? 1
+                             : std::count(linkFrequencies.begin(), linkFrequencies.end(), ',') + 1;
+    auto linkFreqs = ParseLinkValues(linkFrequencies, frequency, nLinks);
+    if (nLinks > 3 || std::set<double>(linkFreqs.begin(), linkFreqs.end()).size() != nLinks)
+    {
+        std::cout << "wrong linkFrequencies parameter (at most one link per band)\n";
+        return 0;
+    }
+
+    // CWmin and cutoff stage of every AC on every link
+    std::map<AcIndex, std::vector<double>> cwminLinksMap = {
+        {AC_BE, ParseLinkValues(acBECwminLinks, acBECwmin, nLinks)},
+        {AC_BK, ParseLinkValues(acBKCwminLinks, acBKCwmin, nLinks)},
+        {AC_VI, ParseLinkValues(acVICwminLinks, acVICwmin, nLinks)},
+        {AC_VO, ParseLinkValues(acVOCwminLinks, acVOCwmin, nLinks)},
+    };
+    std::map<AcIndex, std::vector<double>> cwStageLinksMap = {
+        {AC_BE, ParseLinkValues(acBECwStageLinks, acBECwStage, nLinks)},
+        {AC_BK, ParseLinkValues(acBKCwStageLinks, acBKCwStage, nLinks)},
+        {AC_VI, ParseLinkValues(acVICwStageLinks, acVICwStage, nLinks)},
+        {AC_VO, ParseLinkValues(acVOCwStageLinks, acVOCwStage, nLinks)},
+    };
+    std::map<AcIndex, std::list<uint64_t>> minCwsMap;
+    std::map<AcIndex, std::list<uint64_t>> maxCwsMap;
+    for (const auto& entry : cwminLinksMap)
+    {
+        const auto& cwStages = cwStageLinksMap[entry.first];
+        if (entry.second.empty() || cwStages.empty())
+        {
+            std::cout << "wrong per link CW parameter\n";
+            return 0;
+        }
+        for (std::size_t linkId = 0; linkId < nLinks; ++linkId)
+        {
+            uint64_t cwmin = entry.second[linkId];
+            uint64_t cwmax = cwmin * pow(2, cwStages[linkId]);
+            minCwsMap[entry.first].push_back(cwmin - 1);
+            maxCwsMap[entry.first].push_back(cwmax - 1);
+        }
+    }
     acBECwmin -= 1;
-    uint64_t acBKCwmax = acBKCwmin * pow(2, acBKCwStage);
-    acBKCwmax -= 1;
     acBKCwmin -= 1;
-    uint64_t acVICwmax = acVICwmin * pow(2, acVICwStage);
-    acVICwmax -= 1;
     acVICwmin -= 1;
-    uint64_t acVOCwmax = acVOCwmin * pow(2, acVOCwStage);
-    acVOCwmax -= 1;
     acVOCwmin -= 1;
 
     if (nSld != (nBE + nBK + nVI + nVO))
@@ -221,6 +1618,39 @@ main(int argc, char* argv[])
         return 0;
     }
 
+    // MilliSeconds() would truncate fractional intervals
+    const Time queueProbeInterval = Seconds(queueProbeIntervalMs / 1000);
+    if (queueProbeIntervalMs < 0 ||
+        (queueProbeIntervalMs > 0 && !queueProbeInterval.IsStrictlyPositive()))
+    {
+        std::cout << "wrong queueProbeIntervalMs parameter\n";
+        return 0;
+    }
+    const Time statusInterval = Seconds(statusIntervalMs / 1000);
+    if (!statusFile.empty() && !statusInterval.IsStrictlyPositive())
+    {
+        std::cout << "wrong statusIntervalMs parameter\n";
+        return 0;
+    }
+
+    for (int dir : {acBEDir, acBKDir, acVIDir, acVODir})
+    {
+        if (dir < 0 || dir > 2)
+        {
+            std::cout << "wrong traffic direction parameter\n";
+            return 0;
+        }
+    }
+
+    for (double meanBurst : {acBEMeanBurst, acBKMeanBurst, acVIMeanBurst, acVOMeanBurst})
+    {
+        if (meanBurst < 1 || meanBurst > MAX_MEAN_BURST_SIZE)
+        {
+            std::cout << "wrong mean burst size parameter\n";
+            return 0;
+        }
+    }
+
     // node节点索引与AC类型映射
     std::vector<AcIndex> acList;
 
@@ -229,29 +1659,25 @@ main(int argc, char* argv[])
     for (uint32_t i = 0; i < nVI; ++i) acList.push_back(VIAc);
     for (uint32_t i = 0; i < nVO; ++i) acList.push_back(VOAc);
 
+    // STAs replaying an arrival trace
+    std::set<uint32_t> traceStaSet;
+    std::stringstream traceStasStream(traceStas);
+    for (std::string item; std::getline(traceStasStream, item, ',');)
+    {
+        if (!item.empty())
+        {
+            traceStaSet.insert(std::stoul(item));
+        }
+    }
+
     if (useRts)
     {
         Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("0"));
         Config::SetDefault("ns3::WifiDefaultProtectionManager::EnableMuRts", BooleanValue(true));
     }
 
-    // Disable fragmentation
-    Config::SetDefault("ns3::WifiRemoteStationManager::FragmentationThreshold",
-                       UintegerValue(payloadSize + 100));
-
-    // Make retransmissions persistent
-    Config::SetDefault("ns3::WifiRemoteStationManager::MaxSlrc",
-                       UintegerValue(std::numeric_limits<uint32_t>::max()));
-    Config::SetDefault("ns3::WifiRemoteStationManager::MaxSsrc",
-                       UintegerValue(std::numeric_limits<uint32_t>::max()));
-
-    // Set infinitely long queue
-    Config::SetDefault(
-        "ns3::WifiMacQueue::MaxSize",
-        QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, std::numeric_limits<uint32_t>::max())));
-
-    // Don't drop MPDUs due to long stay in queue
-    Config::SetDefault("ns3::WifiMacQueue::MaxDelay", TimeValue(Seconds(2 * simulationTime)));
+    // No fragmentation, persistent retransmissions and unlimited queues
+    SetEdcaMacDefaults(payloadSize, Seconds(2 * simulationTime));
 
     NodeContainer apNodeCon;
     NodeContainer staNodeCon;
@@ -264,40 +1690,25 @@ main(int argc, char* argv[])
     WifiHelper wifiHelp;
     wifiHelp.SetStandard(WIFI_STANDARD_80211be);
 
-    SpectrumWifiPhyHelper phyHelp{};
+    SpectrumWifiPhyHelper phyHelp{static_cast<uint8_t>(nLinks)};
     phyHelp.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
-    Ptr<MultiModelSpectrumChannel> phySpectrumChannel = CreateObject<
-        MultiModelSpectrumChannel>();
     Ptr<LogDistancePropagationLossModel> lossModel =
         CreateObject<LogDistancePropagationLossModel>();
-    phySpectrumChannel->AddPropagationLossModel(lossModel);
 
     std::string dataModeStr = "EhtMcs" + std::to_string(mcs);
     wifiHelp.SetRemoteStationManager("ns3::ConstantRateWifiManager",
                                      "DataMode",
                                      StringValue(dataModeStr));
-    std::string channelStr = "{0, " + std::to_string(channelWidth) + ", ";
-    if (frequency == 2.4)
-    {
-        channelStr += "BAND_2_4GHZ, 0}";
-        phyHelp.AddChannel(phySpectrumChannel, WIFI_SPECTRUM_2_4_GHZ);
-    }
-    else if (frequency == 5)
-    {
-        channelStr += "BAND_5GHZ, 0}";
-        phyHelp.AddChannel(phySpectrumChannel, WIFI_SPECTRUM_5_GHZ);
-    }
-    else if (frequency == 6)
-    {
-        channelStr += "BAND_6GHZ, 0}";
-        phyHelp.AddChannel(phySpectrumChannel, WIFI_SPECTRUM_6_GHZ);
-    }
-    else
+    for (std::size_t linkId = 0; linkId < nLinks; ++linkId)
     {
-        std::cout << "Unsupported frequency band!\n";
-        return 0;
+        std::string channelStr = AddBandChannel(phyHelp, linkFreqs[linkId], channelWidth, lossModel);
+        if (channelStr.empty())
+        {
+            std::cout << "Unsupported frequency band!\n";
+            return 0;
+        }
+        phyHelp.Set(linkId, "ChannelSettings", StringValue(channelStr));
     }
-    phyHelp.Set("ChannelSettings", StringValue(channelStr));
 
     WifiMacHelper macHelp;
     Ssid bssSsid = Ssid("BSS-SLD-ONLY");
@@ -332,7 +1743,8 @@ main(int argc, char* argv[])
     allNetDevices.Add(apDevCon);
     allNetDevices.Add(staDevCon);
 
-    WifiHelper::AssignStreams(allNetDevices, randomStream);
+    // the streams following those of the devices are used by the applications
+    int64_t appStream = randomStream + WifiHelper::AssignStreams(allNetDevices, randomStream);
 
     Config::Set("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/HeConfiguration/GuardInterval",
                 TimeValue(NanoSeconds(gi)));
@@ -349,45 +1761,8 @@ main(int argc, char* argv[])
                     UintegerValue(maxMpdusInAmpdu * (payloadSize + 50)));
     }
 
-    // Set cwmins and cwmaxs for all Access Categories on both AP and STAs
-    // (including AP because STAs sync with AP via association, probe, and beacon)
-    std::string prefixStr = "/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/";
-    std::list<uint64_t> acBeCwmins = {acBECwmin};
-    std::list<uint64_t> acBeCwmaxs = {acBECwmax};
-    std::list<uint64_t> acBkCwmins = {acBKCwmin};
-    std::list<uint64_t> acBkCwmaxs = {acBKCwmax};
-    std::list<uint64_t> acViCwmins = {acVICwmin};
-    std::list<uint64_t> acViCwmaxs = {acVICwmax};
-    std::list<uint64_t> acVoCwmins = {acVOCwmin};
-    std::list<uint64_t> acVoCwmaxs = {acVOCwmax};
-    Config::Set(prefixStr + "BE_Txop/MinCws", AttributeContainerValue<UintegerValue>(acBeCwmins));
-    Config::Set(prefixStr + "BE_Txop/MaxCws", AttributeContainerValue<UintegerValue>(acBeCwmaxs));
-    Config::Set(prefixStr + "BK_Txop/MinCws", AttributeContainerValue<UintegerValue>(acBkCwmins));
-    Config::Set(prefixStr + "BK_Txop/MaxCws", AttributeContainerValue<UintegerValue>(acBkCwmaxs));
-    Config::Set(prefixStr + "VI_Txop/MinCws", AttributeContainerValue<UintegerValue>(acViCwmins));
-    Config::Set(prefixStr + "VI_Txop/MaxCws", AttributeContainerValue<UintegerValue>(acViCwmaxs));
-    Config::Set(prefixStr + "VO_Txop/MinCws", AttributeContainerValue<UintegerValue>(acVoCwmins));
-    Config::Set(prefixStr + "VO_Txop/MaxCws", AttributeContainerValue<UintegerValue>(acVoCwmaxs));
-
-    // Set all aifsn to 2 (so that all AIFS equal to legacy DIFS)
-    std::list<uint64_t> aifsns_BK = {7};
-    std::list<uint64_t> aifsns_BE = {3};
-    std::list<uint64_t> aifsns = {2};
-    Config::Set(prefixStr + "BE_Txop/Aifsns", AttributeContainerValue<UintegerValue>(aifsns_BE));
-    Config::Set(prefixStr + "BK_Txop/Aifsns", AttributeContainerValue<UintegerValue>(aifsns_BK));
-    Config::Set(prefixStr + "VI_Txop/Aifsns", AttributeContainerValue<UintegerValue>(aifsns));
-    Config::Set(prefixStr + "VO_Txop/Aifsns", AttributeContainerValue<UintegerValue>(aifsns));
-
-    // Set all TXOP limit to 0
-    std::list<Time> txopLimits_BK = {MicroSeconds(0)};
-    std::list<Time> txopLimits_BE = {MicroSeconds(0)};
-    std::list<Time> txopLimits_VI = {MicroSeconds(1536)};
-    std::list<Time> txopLimits_VO = {MicroSeconds(320)};
-
-    Config::Set(prefixStr + "BE_Txop/TxopLimits", AttributeContainerValue<TimeValue>(txopLimits_BE));
-    Config::Set(prefixStr + "BK_Txop/TxopLimits", AttributeContainerValue<TimeValue>(txopLimits_BK));
-    Config::Set(prefixStr + "VI_Txop/TxopLimits", AttributeContainerValue<TimeValue>(txopLimits_VI));
-    Config::Set(prefixStr + "VO_Txop/TxopLimits", AttributeContainerValue<TimeValue>(txopLimits_VO));
+    // Every list of the CW maps holds one value per link
+    SetEdcaParameters(minCwsMap, maxCwsMap);
 
     auto staWifiManager =
         DynamicCast<ConstantRateWifiManager>(DynamicCast<WifiNetDevice>(staDevCon.Get(0))
@@ -434,19 +1809,45 @@ main(int argc, char* argv[])
         psServer->SetStartTime(Seconds(0)); // all servers start at 0 s
     }
     
-    // set the configuration pairs for applications (UL, Bernoulli arrival)
+    // set the configuration pairs for applications (direction per AC, arrival model per trafficType)
     TrafficConfigMap trafficConfigMap; //流量配置表
     double sldDetermIntervalNs = slotTime.GetNanoSeconds() / perSldLambda; //计算确定性时间间隔，每次流量产生之间的固定时间间隔。lambda:平均到达率，表示单位时间内的流量生成次数
 
+    std::map<AcIndex, BurstConfig> burstConfigMap = {
+        {AC_BE, {acBEMeanBurst, acBEOnMs, acBEOffMs}},
+        {AC_BK, {acBKMeanBurst, acBKOnMs, acBKOffMs}},
+        {AC_VI, {acVIMeanBurst, acVIOnMs, acVIOffMs}},
+        {AC_VO, {acVOMeanBurst, acVOOnMs, acVOOffMs}},
+    };
+
+    const std::array<WifiDirection, 3> dirList = {WifiDirection::UPLINK,
+                                                  WifiDirection::DOWNLINK,
+                                                  WifiDirection::BOTH_DIRECTIONS};
+    std::map<AcIndex, WifiDirection> dirMap = {
+        {AC_BE, dirList.at(acBEDir)},
+        {AC_BK, dirList.at(acBKDir)},
+        {AC_VI, dirList.at(acVIDir)},
+        {AC_VO, dirList.at(acVODir)},
+    };
+    bool hasDownlink = false;
+
     for (uint32_t i = 0; i < nSld; ++i) //为每一个STA配置
     {
         AcIndex acType = acList[i];
-        if (trafficType == 0){
-            trafficConfigMap[i] = {WifiDirection::UPLINK, TRAFFIC_DETERMINISTIC, acType, perSldLambda, sldDetermIntervalNs};
+        TrafficConfig config{dirMap[acType], TRAFFIC_BERNOULLI, acType, perSldLambda,
+                             sldDetermIntervalNs, "", burstConfigMap[acType]};
+        hasDownlink = hasDownlink || config.m_dir != WifiDirection::UPLINK;
+        if (trafficType == 2 || traceStaSet.count(i) > 0){
+            config.m_type = TRAFFIC_TRACE;
+            config.m_traceFile = traceFilePrefix + std::to_string(i) + ".bin";
         }
-        else {
-            trafficConfigMap[i] = {WifiDirection::UPLINK, TRAFFIC_BERNOULLI, acType, perSldLambda, sldDetermIntervalNs};
+        else if (trafficType == 0){
+            config.m_type = TRAFFIC_DETERMINISTIC;
         }
+        else if (trafficType == 3){
+            config.m_type = TRAFFIC_BURSTY;
+        }
+        trafficConfigMap[i] = config;
     }
 
     // for (uint32_t i = 0; i < nSld; ++i) //为每一个STA配置
@@ -459,46 +1860,87 @@ main(int argc, char* argv[])
     for (uint32_t i = 0; i < nSld; ++i)
     {
         auto mapIt = trafficConfigMap.find(i);
-        Ptr<Node> clientNode = (mapIt->second.m_dir == WifiDirection::UPLINK) //客户端是STA (uplink)
-                                   ? staNodeCon.Get(i)
-                                   : apNodeCon.Get(0);
-        Ptr<WifiNetDevice> clientDevice = DynamicCast<WifiNetDevice>(clientNode->GetDevice(0)); //获取客户端和服务器节点的 Wi-Fi 网络设备
-        Ptr<Node> serverNode = (mapIt->second.m_dir == WifiDirection::UPLINK) //服务器是AP (uplink)
-                                   ? apNodeCon.Get(0)
-                                   : staNodeCon.Get(i);
-        Ptr<WifiNetDevice> serverDevice = DynamicCast<WifiNetDevice>(serverNode->GetDevice(0));
-
-        switch (mapIt->second.m_type) //设置流量类型
-        {
-        case TRAFFIC_DETERMINISTIC: { //Deterministic 流量
-            PacketSocketAddress sockAddr;
-            sockAddr.SetSingleDevice(clientDevice->GetIfIndex());
-            sockAddr.SetPhysicalAddress(serverDevice->GetAddress());
-            sockAddr.SetProtocol(1);
-            clientNode->AddApplication(GetDeterministicClient(sockAddr, //GetDeterministicClient：创建一个确定性流量客户端应用
+        // mixed direction traffic gets one client on the STA and one on the AP
+        std::vector<WifiDirection> dirs{mapIt->second.m_dir};
+        if (mapIt->second.m_dir == WifiDirection::BOTH_DIRECTIONS)
+        {
+            dirs = {WifiDirection::UPLINK, WifiDirection::DOWNLINK};
+        }
+        for (const auto dir : dirs)
+        {
+            Ptr<Node> clientNode = (dir == WifiDirection::UPLINK) //客户端是STA (uplink)
+                                       ? staNodeCon.Get(i)
+                                       : apNodeCon.Get(0);
+            Ptr<WifiNetDevice> clientDevice = DynamicCast<WifiNetDevice>(clientNode->GetDevice(0)); //获取客户端和服务器节点的 Wi-Fi 网络设备
+            Ptr<Node> serverNode = (dir == WifiDirection::UPLINK) //服务器是AP (uplink)
+                                       ? apNodeCon.Get(0)
+                                       : staNodeCon.Get(i);
+            Ptr<WifiNetDevice> serverDevice = DynamicCast<WifiNetDevice>(serverNode->GetDevice(0));
+
+            switch (mapIt->second.m_type) //设置流量类型
+            {
+            case TRAFFIC_DETERMINISTIC: { //Deterministic 流量
+                PacketSocketAddress sockAddr;
+                sockAddr.SetSingleDevice(clientDevice->GetIfIndex());
+                sockAddr.SetPhysicalAddress(serverDevice->GetAddress());
+                sockAddr.SetProtocol(1);
+                clientNode->AddApplication(GetDeterministicClient(sockAddr, //GetDeterministicClient：创建一个确定性流量客户端应用
+                                                                  payloadSize,
+                                                                  NanoSeconds(
+                                                                      mapIt->second.m_determIntervalNs),
+                                                                  Seconds(startTime->GetValue()),
+                                                                  mapIt->second.m_linkAc)); //m_linkAc 流量的接入类别，用于区分 EDCA 优先级
+                break;
+            }
+            case TRAFFIC_BERNOULLI: { //Bernoulli 流量
+                PacketSocketAddress sockAddr;
+                sockAddr.SetSingleDevice(clientDevice->GetIfIndex());
+                sockAddr.SetPhysicalAddress(serverDevice->GetAddress());
+                sockAddr.SetProtocol(1);
+                clientNode->AddApplication(GetBernoulliClient(sockAddr,
                                                               payloadSize,
-                                                              NanoSeconds(
-                                                                  mapIt->second.m_determIntervalNs),
+                                                              mapIt->second.m_lambda,
+                                                              slotTime,
                                                               Seconds(startTime->GetValue()),
-                                                              mapIt->second.m_linkAc)); //m_linkAc 流量的接入类别，用于区分 EDCA 优先级
-            break;
-        }
-        case TRAFFIC_BERNOULLI: { //Bernoulli 流量
-            PacketSocketAddress sockAddr;
-            sockAddr.SetSingleDevice(clientDevice->GetIfIndex());
-            sockAddr.SetPhysicalAddress(serverDevice->GetAddress());
-            sockAddr.SetProtocol(1);
-            clientNode->AddApplication(GetBernoulliClient(sockAddr,
-                                                          payloadSize,
-                                                          mapIt->second.m_lambda,
-                                                          Seconds(startTime->GetValue()),
-                                                          mapIt->second.m_linkAc)); //
-            break;
-        }
-        default: {
-            std::cerr << "traffic type " << mapIt->second.m_type << " not supported\n";
-            break;
-        }
+                                                              mapIt->second.m_linkAc)); //
+                break;
+            }
+            case TRAFFIC_TRACE: { //trace 回放流量
+                PacketSocketAddress sockAddr;
+                sockAddr.SetSingleDevice(clientDevice->GetIfIndex());
+                sockAddr.SetPhysicalAddress(serverDevice->GetAddress());
+                sockAddr.SetProtocol(1);
+                // the AP replays <prefix>dl-<i>.bin towards STA i
+                std::string traceFile =
+                    (dir == WifiDirection::UPLINK)
+                        ? mapIt->second.m_traceFile
+                        : traceFilePrefix + "dl-" + std::to_string(i) + ".bin";
+                clientNode->AddApplication(GetTraceReplayClient(sockAddr,
+                                                                traceFile,
+                                                                Seconds(startTime->GetValue())));
+                break;
+            }
+            case TRAFFIC_BURSTY: { //批量突发流量
+                PacketSocketAddress sockAddr;
+                sockAddr.SetSingleDevice(clientDevice->GetIfIndex());
+                sockAddr.SetPhysicalAddress(serverDevice->GetAddress());
+                sockAddr.SetProtocol(1);
+                auto client = GetBurstyClient(sockAddr,
+                                              payloadSize,
+                                              mapIt->second.m_lambda,
+                                              burstSizeModel,
+                                              mapIt->second.m_burst,
+                                              Seconds(startTime->GetValue()),
+                                              mapIt->second.m_linkAc);
+                appStream += client->AssignStreams(appStream);
+                clientNode->AddApplication(client);
+                break;
+            }
+            default: {
+                std::cerr << "traffic type " << mapIt->second.m_type << " not supported\n";
+                break;
+            }
+            }
         }
     }
 
@@ -507,13 +1949,141 @@ main(int argc, char* argv[])
     wifiTxStats.Enable(allNetDevices); //启用了 wifiTxStats 对象来收集与 allNetDevices（所有网络设备）相关的传输统计数据
     wifiTxStats.Start(Seconds(5)); //设定了统计的开始时间，即从仿真开始后的第 5 秒开始收集传输统计数据
     wifiTxStats.Stop(Seconds(5 + simulationTime)); //设定了统计的结束时间，即仿真结束时
+    AckedBytes ackedBytes;
+    ackedBytes.m_statsStart = Seconds(5);
+    ackedBytes.m_statsStop = Seconds(5 + simulationTime);
+    EnableAckedBytes(allNodeCon, &ackedBytes);
 
     // phyHelp.EnablePcap("single-bss-sld", allNetDevices);
     // AsciiTraceHelper asciiTrace;
     // phyHelp.EnableAsciiAll(asciiTrace.CreateFileStream("single-bss-sld.tr"));
 
+    // sample the AC queues of every node over the stats window
+    std::map<AcIndex, QueueProbeStats> queueProbeMap;
+    if (queueProbeIntervalMs > 0)
+    {
+        Simulator::Schedule(Seconds(5),
+                            &ProbeQueues,
+                            allNodeCon,
+                            apNodeCon.Get(0)->GetId(),
+                            queueProbeInterval,
+                            Seconds(5 + simulationTime),
+                            &queueProbeMap);
+    }
+
+    if (!macTraceFile.empty())
+    {
+        g_macTraceWriter =
+            std::make_unique<MacTraceWriter>(macTraceFile, allNodeCon.GetN(), macTraceRingSize);
+        if (!g_macTraceWriter->IsOpen())
+        {
+            std::cout << "cannot open " << macTraceFile << "\n";
+            return 0;
+        }
+        g_macTraceSampling = {macTraceSampleBE, macTraceSampleBK, macTraceSampleVI, macTraceSampleVO};
+        g_macTraceRng ^= rngRun;
+        std::stringstream windowsStream(macTraceWindows);
+        for (std::string window; std::getline(windowsStream, window, ',');)
+        {
+            auto sep = window.find('-');
+            g_macTraceWindows.emplace_back(Seconds(std::stod(window.substr(0, sep))),
+                                           Seconds(std::stod(window.substr(sep + 1))));
+        }
+        EnableMacTrace(allNodeCon);
+    }
+
+    PacketRecordExport packetRecords;
+    if (!packetRecordFile.empty())
+    {
+        packetRecords.m_writer =
+            std::make_unique<PacketRecordWriter>(packetRecordFile, packetRecordBlock);
+        if (!packetRecords.m_writer->IsOpen())
+        {
+            std::cout << "cannot open " << packetRecordFile << "\n";
+            return 0;
+        }
+        packetRecords.m_statsStart = Seconds(5);
+        packetRecords.m_statsStop = Seconds(5 + simulationTime);
+        EnablePacketRecords(allNodeCon, &packetRecords);
+    }
+
     Simulator::Stop(Seconds(5 + simulationTime)); //设置仿真结束的时间。在仿真运行到 5 + simulationTime 秒时，仿真会停止
+    auto wallStart = std::chrono::steady_clock::now();
+
+    ProgressStatus progressStatus;
+    if (!statusFile.empty())
+    {
+        std::stringstream config;
+        config << "{\"rngRun\": " << rngRun << ", \"nSld\": " << nSld
+               << ", \"perSldLambda\": " << perSldLambda << ", \"trafficType\": " << trafficType
+               << "}";
+        progressStatus.m_file = statusFile;
+        progressStatus.m_config = config.str();
+        progressStatus.m_statsStart = Seconds(5);
+        progressStatus.m_stop = Seconds(5 + simulationTime);
+        progressStatus.m_wallStart = wallStart;
+        EnableProgressStatus(allNodeCon, &progressStatus);
+        Simulator::Schedule(statusInterval,
+                            &UpdateProgressStatus,
+                            &progressStatus,
+                            statusInterval,
+                            statusWallIntervalS);
+    }
+
     Simulator::Run();
+    std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+
+    if (!statusFile.empty())
+    {
+        WriteProgressStatus(&progressStatus, true);
+    }
+
+    if (!perfStatsFile.empty())
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        std::ofstream perfStats(perfStatsFile);
+        perfStats << "{\"wall_s\": " << wallTime.count()
+                  << ", \"sim_s\": " << Simulator::Now().GetSeconds()
+                  << ", \"events\": " << Simulator::GetEventCount()
+                  << ", \"events_per_s\": " << Simulator::GetEventCount() / wallTime.count()
+                  << ", \"peak_rss_kb\": " << usage.ru_maxrss << "}\n";
+    }
+
+    if (g_macTraceWriter)
+    {
+        g_macTraceWriter->Close();
+        std::clog << "MAC trace: " << g_macTraceWriter->GetWritten() << " events written, "
+                  << g_macTraceWriter->GetDropped() << " dropped (full ring)\n";
+        g_macTraceWriter.reset();
+    }
+
+    if (packetRecords.m_writer)
+    {
+        packetRecords.m_writer->Close();
+        std::clog << "Packet records: " << packetRecords.m_writer->GetRecords() << " records, "
+                  << packetRecords.m_writer->GetBytes() << " bytes\n";
+    }
+
+    // An AC is flagged unstable when its backlog keeps growing within the stats window: the
+    // backlog growth fitted over the probes exceeds queueUnstablePkts. Unlike the final
+    // backlog, the fit neither depends on the backlog accumulated during the warm-up nor on
+    // the value of a single probe.
+    auto finalBacklogMap = GetQueueBacklog(allNodeCon, apNodeCon.Get(0)->GetId());
+    std::map<AcIndex, double> queueGrowthMap; // packets over the stats window
+    std::map<AcIndex, bool> queueUnstableMap;
+    for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+        queueGrowthMap[ac] = queueProbeMap[ac].GetGrowthRate() * simulationTime;
+        queueUnstableMap[ac] = queueProbeIntervalMs > 0 && queueGrowthMap[ac] > queueUnstablePkts;
+        if (queueUnstableMap[ac])
+        {
+            std::clog << "AC " << +ac << " queues are unstable (backlog growth "
+                      << queueGrowthMap[ac] << " packets, final backlog "
+                      << finalBacklogMap[ac].m_packets
+                      << "), its mean delays are not steady state values\n";
+        }
+    }
 
     auto finalResults = wifiTxStats.GetStatistics();
     auto successInfo = wifiTxStats.GetSuccessInfoMap();
@@ -532,110 +2102,114 @@ main(int argc, char* argv[])
     // std::cout << "Length of successInfo (Node IDs): " << successInfoNodeCount << std::endl;
     // std::cout << "Length of successInfo (Total Links): " << successInfoTotalLinks << std::endl;
 
-    // total and mean delay calculation per node and link
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, std::vector<double>>>
-        enqueueTimeMap;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, std::vector<double>>>
-        dequeueTimeMap;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, std::vector<double>>>
-        holTimeMap;
+    // The AP is node 0 and STA i (0-based) is node i + 1. Records are split per AC by their
+    // TID, AP records also per destination STA.
+    const uint32_t apNodeId = apNodeCon.Get(0)->GetId();
+
+    // timestamps of a successfully transmitted MPDU and the link it was transmitted on
+    struct MpduTimes
+    {
+        double m_enqueue;
+        double m_dequeue;
+        uint32_t m_dst;
+        uint8_t m_linkId;
+    };
+
+    // per node and AC, as one AC queue feeds all the links of an MLD
+    std::map<uint32_t /* Node ID */, std::map<AcIndex, std::vector<MpduTimes>>> mpduTimesMap;
+    std::map<AcIndex, uint64_t> successMap;
+    std::map<AcIndex, uint64_t> attemptMap;
+    std::map<uint32_t /* Dst Node ID */, std::map<AcIndex, uint64_t>> dlSuccessMap;
+    std::map<uint8_t /* Link ID */, std::map<AcIndex, uint64_t>> linkSuccessMap;
+    // retries and backoff stage reached (min(retries, CwStage)) per delivered MPDU
+    std::map<AcIndex, std::array<uint64_t, MAX_RETRY_BINS>> retryHistMap;
+    std::map<AcIndex, std::vector<uint64_t>> stageHistMap;
+    for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+        retryHistMap[ac].fill(0);
+        const auto& cwStages = cwStageLinksMap[ac];
+        stageHistMap[ac].assign(
+            static_cast<std::size_t>(*std::max_element(cwStages.begin(), cwStages.end())) + 1,
+            0);
+    }
     for (const auto& nodeMap : successInfo)
     {
+        // AP records only count when downlink traffic is configured
+        if ((nodeMap.first == apNodeId && !hasDownlink) || nodeMap.first > nSld)
+        {
+            continue;
+        }
         for (const auto& linkMap : nodeMap.second)
         {
             for (const auto& record : linkMap.second)
             {
-                enqueueTimeMap[nodeMap.first][linkMap.first].emplace_back(record.m_enqueueMs);
-                dequeueTimeMap[nodeMap.first][linkMap.first].emplace_back(record.m_dequeueMs);
-            }
-            for (uint32_t i = 0; i < enqueueTimeMap[nodeMap.first][linkMap.first].size(); ++i)
-            {
-                if (i == 0)
+                if (record.m_tid >= 8)
                 {
-                    // This value is false (some data packet may be already in queue
-                    // because our stats did not start at 0 second), and will be removed later
-                    holTimeMap[nodeMap.first][linkMap.first].emplace_back(
-                        enqueueTimeMap[nodeMap.first][linkMap.first][i]);
+                    continue; // not QoS data
                 }
-                else
+                // a STA may send several ACs, e.g. when replaying a trace
+                AcIndex type = QosUtilsMapTidToAc(record.m_tid);
+                mpduTimesMap[nodeMap.first][type].push_back(
+                    {record.m_enqueueMs, record.m_dequeueMs, record.m_dstNodeId, linkMap.first});
+                successMap[type] += 1;                  // 成功的包数量
+                linkSuccessMap[linkMap.first][type] += 1;
+                attemptMap[type] += 1 + record.m_failures; // 尝试的总次数 = 成功 + 失败次数
+                ++retryHistMap[type][std::min<std::size_t>(record.m_failures, MAX_RETRY_BINS - 1)];
+                auto& stageHist = stageHistMap[type];
+                ++stageHist[std::min<std::size_t>(record.m_failures, stageHist.size() - 1)];
+                if (nodeMap.first == apNodeId)
                 {
-                    holTimeMap[nodeMap.first][linkMap.first].emplace_back(
-                        std::max(enqueueTimeMap[nodeMap.first][linkMap.first][i],
-                                 dequeueTimeMap[nodeMap.first][linkMap.first][i - 1]));
+                    dlSuccessMap[record.m_dstNodeId][type] += 1;
                 }
             }
-            // remove the first element
-            enqueueTimeMap[nodeMap.first][linkMap.first].erase(
-                enqueueTimeMap[nodeMap.first][linkMap.first].begin());
-            dequeueTimeMap[nodeMap.first][linkMap.first].erase(
-                dequeueTimeMap[nodeMap.first][linkMap.first].begin());
-            holTimeMap[nodeMap.first][linkMap.first].erase(
-                holTimeMap[nodeMap.first][linkMap.first].begin());
-        }
-    }
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, double>>
-        totalQueuingDelayPerNodeLink;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, double>>
-        meanQueuingDelayPerNodeLink;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, double>>
-        totalAccessDelayPerNodeLink;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, double>>
-        meanAccessDelayPerNodeLink;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, std::vector<double>>>
-        accessDelaysPerNodeLink;
-    std::map<uint32_t /* Node ID */, std::map<uint8_t /* Link ID */, std::vector<double>>>
-        e2eDelaysPerNodeLink;
-    for (const auto& nodeMap : successInfo)
-    {
-        for (const auto& linkMap : nodeMap.second)
-        {
-            for (uint32_t i = 0; i < enqueueTimeMap[nodeMap.first][linkMap.first].size(); ++i)
-            {
-                totalQueuingDelayPerNodeLink[nodeMap.first][linkMap.first] += holTimeMap[nodeMap.
-                    first][linkMap.first][i] - enqueueTimeMap[nodeMap.first][
-                    linkMap.first][i];
-                totalAccessDelayPerNodeLink[nodeMap.first][linkMap.first] += dequeueTimeMap[nodeMap.
-                    first][linkMap.first][i] - holTimeMap[nodeMap.first][linkMap.
-                    first][i];
-                accessDelaysPerNodeLink[nodeMap.first][linkMap.first].emplace_back(
-                    dequeueTimeMap[nodeMap.first][linkMap.first][i]
-                    - holTimeMap[nodeMap.first][linkMap.first][i]);
-                e2eDelaysPerNodeLink[nodeMap.first][linkMap.first].emplace_back(
-                    dequeueTimeMap[nodeMap.first][linkMap.first][i]
-                    - enqueueTimeMap[nodeMap.first][linkMap.first][i]);
-            }
-            meanQueuingDelayPerNodeLink[nodeMap.first][linkMap.first] =
-                totalQueuingDelayPerNodeLink[nodeMap.first][linkMap.first] / (finalResults.
-                    m_numSuccessPerNodeLink[nodeMap.first][linkMap.first] - 1);
-            meanAccessDelayPerNodeLink[nodeMap.first][linkMap.first] =
-                totalAccessDelayPerNodeLink[nodeMap.first][linkMap.first] / (finalResults.
-                    m_numSuccessPerNodeLink[nodeMap.first][linkMap.first] - 1);
         }
     }
 
-    // successful tx prob of SLD STAs
-    std::map<AcIndex, uint64_t> successMap;
-    std::map<AcIndex, uint64_t> attemptMap;
-    std::map<AcIndex, double> sldSuccPrMap; // 用于存储每种类型的成功概率
-
-   // 遍历 SLD STAs 进行统计
-    for (uint32_t i = 1; i < 1 + nSld; ++i) // 假设 SLD STAs 索引从 1 开始
+    // queuing delay: enqueue -> head of line, access delay: head of line -> dequeue. An MPDU
+    // reaches the head of its AC queue when it is enqueued or when the previous one is dequeued
+    // from the queue, whatever the link of either. The delays are then attributed to the link
+    // the MPDU was transmitted on.
+    std::map<AcIndex, long double> queDelayTotalMap;
+    std::map<AcIndex, long double> accDelayTotalMap;
+    std::map<uint32_t /* Dst Node ID */, std::map<AcIndex, long double>> dlQueDelayTotalMap;
+    std::map<uint32_t /* Dst Node ID */, std::map<AcIndex, long double>> dlAccDelayTotalMap;
+    std::map<uint8_t /* Link ID */, std::map<AcIndex, long double>> linkQueDelayTotalMap;
+    std::map<uint8_t /* Link ID */, std::map<AcIndex, long double>> linkAccDelayTotalMap;
+    std::map<AcIndex, std::vector<double>> e2eDelaysMap; // for the delay percentiles
+    for (auto& nodeMap : mpduTimesMap)
     {
-        AcIndex type = acList[i - 1]; // 从 acList 获取类型，注意索引从 0 开始
-
-        // 获取与当前 STA 对应的成功传输信息
-        const auto& linkMap = successInfo[i];
-        for (const auto& records : linkMap)
+        for (auto& acMap : nodeMap.second)
         {
-            for (const auto& pkt : records.second)
+            // merge the links in dequeue order
+            auto& times = acMap.second;
+            std::stable_sort(times.begin(),
+                             times.end(),
+                             [](const MpduTimes& a, const MpduTimes& b) {
+                                 return a.m_dequeue < b.m_dequeue;
+                             });
+            // The first MPDU is skipped: it may have been queued before the stats started
+            for (std::size_t i = 1; i < times.size(); ++i)
             {
-                // 更新总的统计值
-                successMap[type] += 1;                       // 成功的包数量
-                attemptMap[type] += 1 + pkt.m_failures;      // 尝试的总次数 = 成功 + 失败次数
+                double hol = std::max(times[i].m_enqueue, times[i - 1].m_dequeue);
+                double queDelay = hol - times[i].m_enqueue;
+                double accDelay = times[i].m_dequeue - hol;
+                queDelayTotalMap[acMap.first] += queDelay;
+                accDelayTotalMap[acMap.first] += accDelay;
+                linkQueDelayTotalMap[times[i].m_linkId][acMap.first] += queDelay;
+                linkAccDelayTotalMap[times[i].m_linkId][acMap.first] += accDelay;
+                e2eDelaysMap[acMap.first].push_back(queDelay + accDelay);
+                if (nodeMap.first == apNodeId)
+                {
+                    dlQueDelayTotalMap[times[i].m_dst][acMap.first] += queDelay;
+                    dlAccDelayTotalMap[times[i].m_dst][acMap.first] += accDelay;
+                }
             }
         }
     }
 
+    // successful tx prob per AC
+    std::map<AcIndex, double> sldSuccPrMap; // 用于存储每种类型的成功概率
+
     for (const auto& entry : successMap)
     {
         AcIndex type = entry.first;
@@ -665,6 +2239,15 @@ main(int argc, char* argv[])
 
     // 计算所有类型的吞吐量 (sldThpt)
     std::map<AcIndex, double> sldThptMap; // 用于存储每种类型的吞吐量
+    // nodes whose records are counted in successMap
+    auto isCountedNode = [apNodeId, hasDownlink, nSld](uint32_t nodeId) {
+        return (nodeId != apNodeId || hasDownlink) && nodeId <= nSld;
+    };
+    std::map<AcIndex, double> meanSizeMap; // mean acknowledged payload size (bytes)
+    for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+        meanSizeMap[ac] = GetMeanAckedSize(ackedBytes, ac, isCountedNode, payloadSize);
+    }
 
     for (const auto& entry : successMap)
     {
@@ -672,37 +2255,15 @@ main(int argc, char* argv[])
         uint64_t successCount = entry.second;
 
         // 吞吐量计算公式
-        double sldThpt = static_cast<long double>(successCount) * payloadSize * 8 /
+        double sldThpt = static_cast<long double>(successCount) * meanSizeMap[type] * 8 /
                         simulationTime / 1000000; // 转为 Mbps
         sldThptMap[type] = sldThpt;
     }
 
-    std::map<AcIndex, long double> queDelayTotalMap;
-    std::map<AcIndex, long double> accDelayTotalMap;
     std::map<AcIndex, double> meanQueDelayMap;
     std::map<AcIndex, double> meanAccDelayMap;
     std::map<AcIndex, double> meanE2eDelayMap;
 
-    // 遍历 SLD STAs 按类型统计队列延迟和接入延迟
-    for (uint32_t i = 1; i < 1 + nSld; ++i) // 假设 SLD STAs 索引从 1 开始
-    {
-        AcIndex type = acList[i - 1]; // 从 acList 获取类型，注意索引从 0 开始
-
-        // 队列延迟统计
-        const auto& queLinkMap = totalQueuingDelayPerNodeLink[i];
-        for (const auto& item : queLinkMap)
-        {
-            queDelayTotalMap[type] += item.second;
-        }
-
-        // 接入延迟统计
-        const auto& accLinkMap = totalAccessDelayPerNodeLink[i];
-        for (const auto& item : accLinkMap)
-        {
-            accDelayTotalMap[type] += item.second;
-        }
-    }
-
     for (const auto& entry : successMap)
     {
         AcIndex type = entry.first;
@@ -724,6 +2285,16 @@ main(int argc, char* argv[])
         }
     }
 
+    // 99th percentile of the end-to-end delay per AC (nearest rank)
+    std::map<AcIndex, double> p99E2eDelayMap;
+    for (auto& entry : e2eDelaysMap)
+    {
+        auto& delays = entry.second;
+        auto rank = std::min<std::size_t>(std::ceil(0.99 * delays.size()), delays.size()) - 1;
+        std::nth_element(delays.begin(), delays.begin() + rank, delays.end());
+        p99E2eDelayMap[entry.first] = delays[rank];
+    }
+
     double sldSuccPr_BE = sldSuccPrMap[AC_BE];
     double sldSuccPr_BK = sldSuccPrMap[AC_BK];
     double sldSuccPr_VI = sldSuccPrMap[AC_VI];
@@ -812,9 +2383,185 @@ main(int argc, char* argv[])
             << acVICwmin << ","
             << +acVICwStage << ","
             << acVOCwmin << ","
-            << +acVOCwStage << "\n";
+            << +acVOCwStage;
+        // queue backlog per AC: mean, max and final packets and bytes, max HOL age, unstable
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            const auto& stats = queueProbeMap[ac];
+            double samples = std::max<uint64_t>(stats.m_samples, 1);
+            g_fileSummary << "," << stats.m_sumPackets / samples
+                          << "," << stats.m_maxPackets
+                          << "," << finalBacklogMap[ac].m_packets
+                          << "," << stats.m_sumBytes / samples
+                          << "," << stats.m_maxBytes
+                          << "," << finalBacklogMap[ac].m_bytes
+                          << "," << std::max(stats.m_maxHolAgeMs, finalBacklogMap[ac].m_holAgeMs)
+                          << "," << queueUnstableMap[ac];
+        }
+        // 99th percentile end-to-end delay per AC
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            g_fileSummary << "," << p99E2eDelayMap[ac];
+        }
+        // backlog growth over the stats window and largest backlog of a single STA per AC
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            g_fileSummary << "," << queueGrowthMap[ac] << ","
+                          << std::max(queueProbeMap[ac].m_maxStaPackets,
+                                      finalBacklogMap[ac].m_maxStaPackets);
+        }
+        g_fileSummary << "\n";
     }
     g_fileSummary.close();
+
+    // Retry and backoff stage distributions per AC, with the stage probabilities of the
+    // backoff chain given the measured collision probability (chain) and of the saturated
+    // fixed point (model). The contenders of an AC are its STAs sending uplink and, when the AC
+    // has downlink traffic, the AP (its ACs are taken as independent stations, internal
+    // collisions are not modelled). The model has a single CW per AC, so the file is only
+    // written when every link uses the same CWs. One row per AC with contenders, lists are ';'
+    // separated:
+    //   rngRun,nSld,perSldLambda,ac,cwmin,cwStage,aifsn,successes,attempts,pMeasured,pModel,
+    //   tauModel,retries,stages,chainStages,modelStages
+    auto allEqual = [](const std::vector<double>& values) {
+        return std::all_of(values.begin(), values.end(), [&values](double value) {
+            return value == values.front();
+        });
+    };
+    bool sameLinkCws = true;
+    for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+        sameLinkCws = sameLinkCws && allEqual(cwminLinksMap[ac]) && allEqual(cwStageLinksMap[ac]);
+    }
+    if (printTxStatsSingleLine && !sameLinkCws)
+    {
+        std::clog << "The CWs differ between links, wifi-edca-retries.dat is not written\n";
+    }
+    if (printTxStatsSingleLine && sameLinkCws)
+    {
+        std::map<AcIndex, BackoffModelAc> backoffModel;
+        uint64_t minAifsn = std::numeric_limits<uint64_t>::max();
+        for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+        {
+            auto nStas = static_cast<uint32_t>(std::count(acList.begin(), acList.end(), ac));
+            uint32_t nContenders = 0;
+            if (nStas > 0)
+            {
+                nContenders = (dirMap[ac] != WifiDirection::DOWNLINK ? nStas : 0) +
+                              (dirMap[ac] != WifiDirection::UPLINK ? 1 : 0);
+            }
+            if (nContenders > 0)
+            {
+                backoffModel[ac] = {cwminLinksMap[ac][0],
+                                    static_cast<uint32_t>(cwStageLinksMap[ac][0]),
+                                    0,
+                                    nContenders};
+                minAifsn = std::min(minAifsn, GetEdcaAifsn(ac));
+            }
+        }
+        for (auto& entry : backoffModel)
+        {
+            entry.second.m_aifsOffset = GetEdcaAifsn(entry.first) - minAifsn;
+        }
+        SolveBackoffModel(backoffModel);
+
+        auto printList = [](std::ostream& out, const auto& values) {
+            for (std::size_t i = 0; i < values.size(); ++i)
+            {
+                out << (i == 0 ? "" : ";") << values[i];
+            }
+        };
+        std::ofstream retryFileSummary("wifi-edca-retries.dat", std::ofstream::app);
+        for (const auto& entry : backoffModel)
+        {
+            AcIndex ac = entry.first;
+            const auto& model = entry.second;
+            double measuredP =
+                attemptMap[ac] > 0 ? 1 - static_cast<double>(successMap[ac]) / attemptMap[ac] : 0;
+            retryFileSummary << rngRun << "," << nSld << "," << perSldLambda << "," << +ac << ","
+                             << model.m_cwmin << "," << model.m_cwStage << ","
+                             << GetEdcaAifsn(ac) << "," << successMap[ac] << "," << attemptMap[ac]
+                             << "," << measuredP << "," << model.m_p << "," << model.m_tau << ",";
+            printList(retryFileSummary, retryHistMap[ac]);
+            retryFileSummary << ",";
+            printList(retryFileSummary, stageHistMap[ac]);
+            retryFileSummary << ",";
+            printList(retryFileSummary, GetStageProbabilities(measuredP, model.m_cwStage));
+            retryFileSummary << ",";
+            printList(retryFileSummary, GetStageProbabilities(model.m_p, model.m_cwStage));
+            retryFileSummary << "\n";
+        }
+    }
+
+    // MLD stats, one row per link and AC
+    if (printTxStatsSingleLine && nLinks > 1)
+    {
+        std::ofstream linkFileSummary("wifi-edca-links.dat", std::ofstream::app);
+        for (const auto& linkMap : linkSuccessMap)
+        {
+            for (const auto& entry : linkMap.second)
+            {
+                uint64_t successCount = entry.second;
+                double linkThpt = static_cast<long double>(successCount) *
+                                  meanSizeMap[entry.first] * 8 / simulationTime / 1000000;
+                double linkMeanQueDelay =
+                    linkQueDelayTotalMap[linkMap.first][entry.first] / successCount;
+                double linkMeanAccDelay =
+                    linkAccDelayTotalMap[linkMap.first][entry.first] / successCount;
+                linkFileSummary << +linkMap.first << ","
+                                << linkFreqs.at(linkMap.first) << ","
+                                << +entry.first << ","
+                                << successCount << ","
+                                << linkThpt << ","
+                                << linkMeanQueDelay << ","
+                                << linkMeanAccDelay << ","
+                                << linkMeanQueDelay + linkMeanAccDelay << ","
+                                << rngRun << ","
+                                << simulationTime << ","
+                                << nSld << ","
+                                << perSldLambda << ","
+                                << nLinks << "\n";
+            }
+        }
+    }
+
+    // downlink stats collected at the AP, one row per destination STA and AC
+    if (printTxStatsSingleLine && hasDownlink)
+    {
+        std::ofstream dlFileSummary("wifi-edca-dl.dat", std::ofstream::app);
+        for (const auto& dstMap : dlSuccessMap)
+        {
+            for (const auto& entry : dstMap.second)
+            {
+                uint64_t successCount = entry.second;
+                double dlMeanSize = GetMeanAckedSize(
+                    ackedBytes,
+                    entry.first,
+                    [apNodeId](uint32_t nodeId) { return nodeId == apNodeId; },
+                    payloadSize,
+                    dstMap.first);
+                double dlThpt = static_cast<long double>(successCount) * dlMeanSize * 8 /
+                                simulationTime / 1000000;
+                double dlMeanQueDelay = dlQueDelayTotalMap[dstMap.first][entry.first] / successCount;
+                double dlMeanAccDelay = dlAccDelayTotalMap[dstMap.first][entry.first] / successCount;
+                dlFileSummary << dstMap.first << ","
+                              << +entry.first << ","
+                              << successCount << ","
+                              << dlThpt << ","
+                              << dlMeanQueDelay << ","
+                              << dlMeanAccDelay << ","
+                              << dlMeanQueDelay + dlMeanAccDelay << ","
+                              << rngRun << ","
+                              << simulationTime << ","
+                              << nSld << ","
+                              << perSldLambda << ","
+                              << acBEDir << ","
+                              << acBKDir << ","
+                              << acVIDir << ","
+                              << acVODir << "\n";
+            }
+        }
+    }
     Simulator::Destroy();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// Converts a CSV arrival trace ("time_ns,size,tid" per line, '#' for comments)
+// into the binary format replayed by single-bss-sld-edca (trafficType=2). Sizes are
+// limited to the MTU of the wifi device (TRACE_REPLAY_MAX_SIZE).
+
+#include "trace-replay-format.h"
+
+#include "ns3/command-line.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "CSV trace (time_ns,size,tid)", input);
+    cmd.AddValue("output", "Binary trace to write", output);
+    cmd.Parse(argc, argv);
+
+    std::ifstream in(input);
+    if (!in)
+    {
+        std::cout << "cannot open " << input << "\n";
+        return 1;
+    }
+    std::FILE* out = std::fopen(output.c_str(), "wb");
+    if (!out)
+    {
+        std::cout << "cannot open " << output << "\n";
+        return 1;
+    }
+
+    // the header is rewritten with the record count once the input is consumed
+    TraceReplayFileHeader header;
+    InitTraceReplayHeader(header, 0);
+    std::fwrite(&header, sizeof(header), 1, out);
+
+    // a partial output must not be mistaken for a valid trace
+    auto fail = [out, &output]() {
+        std::fclose(out);
+        std::remove(output.c_str());
+        return 1;
+    };
+
+    uint64_t numRecords = 0;
+    uint64_t lineNumber = 0;
+    uint64_t lastTimeNs = 0;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        unsigned long long timeNs;
+        unsigned int size;
+        unsigned int tid;
+        if (std::sscanf(line.c_str(), "%llu,%u,%u", &timeNs, &size, &tid) != 3 || tid > 7)
+        {
+            std::cout << "malformed line " << lineNumber << ": " << line << "\n";
+            return fail();
+        }
+        // the packet socket of the wifi device would silently drop larger packets
+        if (size > TRACE_REPLAY_MAX_SIZE)
+        {
+            std::cout << "size " << size << " above the MTU (" << TRACE_REPLAY_MAX_SIZE
+                      << " bytes) at line " << lineNumber << "\n";
+            return fail();
+        }
+        if (timeNs < lastTimeNs)
+        {
+            std::cout << "arrivals must be sorted by time (line " << lineNumber << ")\n";
+            return fail();
+        }
+        lastTimeNs = timeNs;
+        TraceReplayRecord record{timeNs,
+                                 static_cast<uint16_t>(size),
+                                 static_cast<uint8_t>(tid),
+                                 0};
+        std::fwrite(&record, sizeof(record), 1, out);
+        ++numRecords;
+    }
+
+    InitTraceReplayHeader(header, numRecords);
+    std::fseek(out, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, out);
+    std::fclose(out);
+    std::cout << numRecords << " records written to " << output << "\n";
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TRACE_REPLAY_FORMAT_H
+#define TRACE_REPLAY_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * On-disk layout of a packet arrival trace replayed by the trace-replay client
+ * of single-bss-sld-edca (one file per STA).
+ *
+ * The file is a TraceReplayFileHeader followed by m_numRecords TraceReplayRecords,
+ * all little endian, sorted by non-decreasing m_timeNs. Arrival times are relative
+ * to the start time of the client application, so one trace can be reused with
+ * the random start times of the scenario.
+ */
+constexpr char TRACE_REPLAY_MAGIC[8] = {'E', 'D', 'C', 'A', 'T', 'R', 'C', '1'};
+constexpr uint32_t TRACE_REPLAY_VERSION = 1;
+
+// Largest payload a packet socket accepts on a wifi device (default WifiNetDevice MTU)
+constexpr uint32_t TRACE_REPLAY_MAX_SIZE = 2296;
+
+struct TraceReplayFileHeader
+{
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_recordSize;  // sizeof(TraceReplayRecord), to reject mismatched writers
+    uint64_t m_numRecords;
+};
+
+#pragma pack(push, 1)
+
+struct TraceReplayRecord
+{
+    uint64_t m_timeNs;  // arrival time since client start (ns)
+    uint16_t m_size;    // application payload size (bytes)
+    uint8_t m_tid;      // TID used as socket priority, mapped to an AC by the MAC
+    uint8_t m_reserved; // keep records 12 bytes wide
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(TraceReplayFileHeader) == 24, "unexpected trace header size");
+static_assert(sizeof(TraceReplayRecord) == 12, "unexpected trace record size");
+
+inline void
+InitTraceReplayHeader(TraceReplayFileHeader& header, uint64_t numRecords)
+{
+    std::memcpy(header.m_magic, TRACE_REPLAY_MAGIC, sizeof(header.m_magic));
+    header.m_version = TRACE_REPLAY_VERSION;
+    header.m_recordSize = sizeof(TraceReplayRecord);
+    header.m_numRecords = numRecords;
+}
+
+inline bool
+IsValidTraceReplayHeader(const TraceReplayFileHeader& header)
+{
+    return std::memcmp(header.m_magic, TRACE_REPLAY_MAGIC, sizeof(header.m_magic)) == 0 &&
+           header.m_version == TRACE_REPLAY_VERSION &&
+           header.m_recordSize == sizeof(TraceReplayRecord);
+}
+
+#endif /* TRACE_REPLAY_FORMAT_H */